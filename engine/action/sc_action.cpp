@@ -267,6 +267,19 @@ struct action_execute_event_t : public player_event_t
   }
 };
 
+// Sum of the change counters of the actor (and its owner) that the target independent part of a
+// snapshot depends on
+uint64_t snapshot_inputs_version( const player_t* p )
+{
+  uint64_t v = p -> snapshot_version + p -> resources.version;
+  if ( p -> is_pet() )
+  {
+    const player_t* o = p -> cast_pet() -> owner;
+    v += o -> snapshot_version + o -> resources.version;
+  }
+  return v;
+}
+
 struct power_entry_without_aura
 {
   bool operator()( const spellpower_data_t* p )
@@ -395,6 +408,8 @@ action_t::action_t( action_e       ty,
   aoe(),
   dual(),
   callbacks( true ),
+  partial_snapshot( false ),
+  batch_snapshot( true ),
   special(),
   channeled(),
   sequence(),
@@ -502,10 +517,13 @@ action_t::action_t( action_e       ty,
   total_executions(),
   line_cooldown( "line_cd", *p ),
   signature(),
+  ready_gated( false ),
+  ready_ignores_cooldown( false ),
   execute_state(),
   pre_execute_state(),
   snapshot_flags(),
   update_flags( STATE_TGT_MUL_DA | STATE_TGT_MUL_TA | STATE_TGT_CRIT),
+  state_copy_flags( ~0U ),
   target_cache(),
   options(),
   state_cache(),
@@ -897,9 +915,10 @@ double action_t::cost() const
   // determine the cost, if the default behavior is not universal.
   else
   {
-    if ( player -> resources.current[ cr ] >= base_costs[ cr ] )
+    double current = player -> resource_current( cr );
+    if ( current >= base_costs[ cr ] )
     {
-      c = std::min( base_cost(), player -> resources.current[ cr ] );
+      c = std::min( base_cost(), current );
     }
     else
     {
@@ -1330,11 +1349,12 @@ size_t action_t::available_targets( std::vector< player_t* >& tl ) const
 std::vector< player_t* >& action_t::target_list() const
 {
   // Check if target cache is still valid. If not, recalculate it
-  if ( !target_cache.is_valid )
+  if ( !target_cache.is_valid || target_cache.spatial_version != sim -> spatial_index.version )
   {
     available_targets( target_cache.list ); // This grabs the full list of targets, which will also pickup various awfulness that some classes have.. such as prismatic crystal.
     check_distance_targeting( target_cache.list );
     target_cache.is_valid = true;
+    target_cache.spatial_version = sim -> spatial_index.version;
   }
 
   return target_cache.list;
@@ -1397,6 +1417,8 @@ block_result_e action_t::calculate_block_result( action_state_t* s ) const
 
 void action_t::execute()
 {
+  sim -> state_epoch++;
+
 #ifndef NDEBUG
   if ( ! initialized )
   {
@@ -1443,16 +1465,42 @@ void action_t::execute()
   {
     std::vector< player_t* >& tl = target_list();
     num_targets = ( n_targets() < 0 ) ? tl.size() : std::min( tl.size(), as<size_t>( n_targets() ) );
+
+    // With aoe_batch_snapshot, the state is fully snapshot once and copied to each target, which
+    // only snapshots the target specific variables, and the multipliers whose composites take the
+    // state ( and thus may depend on its target or chain target ). The shared state is snapshot
+    // again if impacts on the previous targets changed the actor.
+    bool batch = sim -> aoe_batch_snapshot && batch_snapshot && ! pre_execute_state && num_targets > 1;
+    action_state_t* batch_state = nullptr;
+    uint64_t batch_version = 0;
+
     for ( size_t t = 0, max_targets = tl.size(); t < num_targets && t < max_targets; t++ )
     {
-      action_state_t* s = get_state( pre_execute_state );
+      if ( batch && ( ! batch_state || batch_version != snapshot_inputs_version( player ) ) )
+      {
+        if ( ! batch_state )
+          batch_state = get_state();
+        batch_state -> target = tl[ t ];
+        batch_state -> n_targets = std::min( num_targets, tl.size() );
+        batch_state -> chain_target = as<int>( t );
+        snapshot_state( batch_state, amount_type( batch_state ) );
+        batch_version = snapshot_inputs_version( player );
+      }
+
+      action_state_t* s = get_state( batch ? batch_state : pre_execute_state );
       s -> target = tl[ t ];
       s -> n_targets = std::min( num_targets, tl.size() );
       s -> chain_target = as<int>( t );
-      if ( ! pre_execute_state )
+      if ( ! pre_execute_state && ! batch )
       {
         snapshot_state( s, amount_type( s ) );
       }
+      else if ( batch )
+      {
+        snapshot_internal( s, snapshot_flags & ( STATE_TARGET | STATE_MUL_DA | STATE_MUL_TA |
+                                                 STATE_MUL_PERSISTENT | STATE_VERSATILITY | STATE_MUL_PET ),
+                           amount_type( s ) );
+      }
       // Even if pre-execute state is defined, we need to snapshot target-specific state variables
       // for aoe spells.
       else
@@ -1469,6 +1517,9 @@ void action_t::execute()
 
       schedule_travel( s );
     }
+
+    if ( batch_state )
+      action_state_t::release( batch_state );
   }
   else // single target
   {
@@ -1526,13 +1577,13 @@ void action_t::execute()
       // "On spell cast", only performed for foreground actions
       if ( ( pt2 = execute_state -> cast_proc_type2() ) != PROC2_INVALID )
       {
-        action_callback_t::trigger( player -> callbacks.procs[ pt ][ pt2 ], this, execute_state );
+        trigger_proc_callbacks( pt, pt2, execute_state );
       }
 
       // "On an execute result"
       if ( ( pt2 = execute_state -> execute_proc_type2() ) != PROC2_INVALID )
       {
-        action_callback_t::trigger( player -> callbacks.procs[ pt ][ pt2 ], this, execute_state );
+        trigger_proc_callbacks( pt, pt2, execute_state );
       }
     }
   }
@@ -1678,6 +1729,8 @@ void action_t::record_data( action_state_t* data )
 // a queued off-gcd execution.
 void action_t::queue_execute( bool off_gcd )
 {
+  sim -> state_epoch++;
+
   auto queue_delay = cooldown -> queue_delay();
   if ( queue_delay > timespan_t::zero() )
   {
@@ -1707,6 +1760,8 @@ void action_t::queue_execute( bool off_gcd )
       schedule_execute();
     }
   }
+
+  sim -> state_epoch++;
 }
 
 void action_t::schedule_execute( action_state_t* execute_state )
@@ -1801,14 +1856,31 @@ void action_t::reschedule_execute( timespan_t time )
   {
     execute_event -> reschedule( time );
   }
-  else // Impossible to reschedule events "early".  Need to be canceled and re-created.
+  else // Events can only be rescheduled later, move the event earlier in place
   {
-    action_state_t* state = debug_cast<action_execute_event_t*>( execute_event ) -> execute_state;
-    event_t::cancel( execute_event );
-    execute_event = start_action_execute_event( time, state );
+    adjust_execute_event( time );
   }
 }
 
+// action_t::adjust_execute_event ===========================================
+
+void action_t::adjust_execute_event( timespan_t time, bool keep_state )
+{
+  assert( execute_event );
+
+  if ( ! keep_state )
+  {
+    auto e = debug_cast<action_execute_event_t*>( execute_event );
+    if ( e -> execute_state )
+    {
+      action_state_t::release( e -> execute_state );
+      e -> execute_state = nullptr;
+    }
+  }
+
+  execute_event -> adjust( time );
+}
+
 // action_t::update_ready ===================================================
 
 void action_t::update_ready( timespan_t cd_duration /* = timespan_t::min() */ )
@@ -1885,8 +1957,65 @@ bool action_t::usable_moving() const
 
 // action_t::ready ==========================================================
 
+// action_t::earliest_ready_time ===========================================
+
+// Earliest time at which the cooldown, internal cooldown, and line cooldown checks at the start of
+// action_t::ready() can pass. The bound is computed from the live cooldown state, so cooldown
+// resets and adjustments are always reflected. The line cooldown is only taken into account if the
+// action cannot roll a false negative, as that roll happens before the line cooldown check, and
+// skipping the ready() call would otherwise change the random number stream.
+
+timespan_t action_t::earliest_ready_time() const
+{
+  timespan_t t = cooldown -> ready;
+  if ( cooldown -> action && cooldown -> player )
+  {
+    t -= cooldown -> player -> cooldown_tolerance();
+  }
+
+  if ( internal_cooldown -> ready > t )
+  {
+    t = internal_cooldown -> ready;
+  }
+
+  if ( line_cooldown.ready > t && false_negative_pct() <= 0 )
+  {
+    t = line_cooldown.ready;
+  }
+
+  return t;
+}
+
+// action_t::profiled_ready ================================================
+
+// ready() with APL line profiling. The reason for a failure is classified after the fact, in the
+// same order as action_t::ready() checks it: cooldowns first, then resources, and everything else
+// (expressions, movement, class module overrides) as a condition failure.
+
+bool action_t::profiled_ready()
+{
+  apl_profile.evaluations++;
+
+  apl_profile.start();
+  bool r = ready();
+  apl_profile.stop();
+
+  if ( r )
+    apl_profile.ready++;
+  else if ( ! cooldown -> is_ready() || internal_cooldown -> down() || line_cooldown.down() )
+    apl_profile.fail_cooldown++;
+  else if ( ! player -> resource_available( current_resource(), cost() ) )
+    apl_profile.fail_resource++;
+  else
+    apl_profile.fail_condition++;
+
+  return r;
+}
+
 bool action_t::ready()
 {
+  ready_gated = ! ready_ignores_cooldown;
+
   // Check conditions that do NOT pertain to the target before cycle_targets
   if ( cooldown -> is_ready() == false )
     return false;
@@ -1940,32 +2069,44 @@ bool action_t::ready()
   if ( option.cycle_targets )
   {
     player_t* saved_target = target;
-    option.cycle_targets = false;
-    bool found_ready = false;
+    player_t* found_target = nullptr;
 
-    // Note, need to take a copy of the original target list here, instead of a reference. Otherwise
-    // if spell_targets (or any expression that uses the target list) modifies it, the loop below
-    // may break, since the number of elements on the vector is not the same as it originally was
-    std::vector< player_t* > ctl = target_list();
-    size_t num_targets = ctl.size();
+    if ( target_memo_valid( cycle_targets_memo ) )
+    {
+      found_target = cycle_targets_memo.result;
+    }
+    else
+    {
+      option.cycle_targets = false;
 
-    if ( ( option.max_cycle_targets > 0 ) && ( ( size_t ) option.max_cycle_targets < num_targets ) )
-      num_targets = option.max_cycle_targets;
+      // Note, need to take a copy of the original target list here, instead of a reference. Otherwise
+      // if spell_targets (or any expression that uses the target list) modifies it, the loop below
+      // may break, since the number of elements on the vector is not the same as it originally was.
+      // The copy is made into a scratch list owned by the action to avoid allocating on every call.
+      const std::vector< player_t* >& tl = target_list();
+      cycle_targets_list.assign( tl.begin(), tl.end() );
+      size_t num_targets = cycle_targets_list.size();
 
-    for ( size_t i = 0; i < num_targets; i++ )
-    {
-      target = ctl[i];
-      if ( ready() )
+      if ( ( option.max_cycle_targets > 0 ) && ( ( size_t ) option.max_cycle_targets < num_targets ) )
+        num_targets = option.max_cycle_targets;
+
+      for ( size_t i = 0; i < num_targets; i++ )
       {
-        found_ready = true;
-        break;
+        target = cycle_targets_list[i];
+        if ( ready() )
+        {
+          found_target = target;
+          break;
+        }
       }
-    }
 
-    option.cycle_targets = true;
+      option.cycle_targets = true;
+      update_target_memo( cycle_targets_memo, saved_target, found_target );
+    }
 
-    if ( found_ready )
+    if ( found_target )
     {
+      target = found_target;
       // If the target changes, we need to regenerate the target cache to get the new primary target
       // as the first element of target_list. Only do this for abilities that are aoe.
       if ( n_targets() > 1 && target != saved_target )
@@ -2254,9 +2395,74 @@ bool action_t::init_finished()
     ret = false;
   }
 
+  if ( callbacks )
+    init_proc_callbacks();
+
   return ret;
 }
 
+// action_t::init_proc_callbacks ============================================
+
+void action_t::init_proc_callbacks()
+{
+  auto& cbs = player -> callbacks;
+
+  proc_callbacks.version = cbs.version;
+  proc_callbacks.weapon = weapon;
+  proc_callbacks.lists.assign( PROC1_TYPE_MAX * PROC2_TYPE_MAX, nullptr );
+
+  std::vector<action_callback_t*> list;
+  for ( proc_types pt = PROC1_TYPE_MIN; pt < PROC1_TYPE_MAX; pt++ )
+  {
+    for ( proc_types2 pt2 = PROC2_TYPE_MIN; pt2 < PROC2_TYPE_MAX; pt2++ )
+    {
+      const auto& all = cbs.procs[ pt ][ pt2 ];
+
+      // Callbacks that do not allow procs end the triggering for proc actions, so they are kept
+      // regardless of the filter
+      list.clear();
+      range::copy_if( all, std::back_inserter( list ), [ this ]( const action_callback_t* cb ) {
+        return cb -> can_trigger( this ) || ( proc && ! cb -> allow_procs );
+      } );
+
+      proc_callbacks.lists[ pt * PROC2_TYPE_MAX + pt2 ] = list.size() == all.size()
+        ? &all : cbs.filtered_list( list );
+
+      if ( sim -> debug && list.size() != all.size() )
+        sim -> out_debug.printf( "%s %s filters %s%s proc callbacks from %u to %u",
+            player -> name(), name(), util::proc_type_string( pt ), util::proc_type2_string( pt2 ),
+            as<unsigned>( all.size() ), as<unsigned>( list.size() ) );
+    }
+  }
+}
+
+// action_t::trigger_proc_callbacks =========================================
+
+void action_t::trigger_proc_callbacks( proc_types pt, proc_types2 pt2, action_state_t* state )
+{
+  const auto& all = player -> callbacks.procs[ pt ][ pt2 ];
+
+  if ( sim -> filter_proc_callbacks == 0 || all.empty() )
+  {
+    action_callback_t::trigger( all, this, state );
+    return;
+  }
+
+  if ( proc_callbacks.lists.empty() || proc_callbacks.version != player -> callbacks.version ||
+       proc_callbacks.weapon != weapon )
+    init_proc_callbacks();
+
+  const auto& list = *proc_callbacks.lists[ pt * PROC2_TYPE_MAX + pt2 ];
+
+  if ( sim -> filter_proc_callbacks > 1 && player -> in_combat )
+  {
+    player -> callbacks.filtered_visits += list.size();
+    player -> callbacks.filtered_skips += all.size() - list.size();
+  }
+
+  action_callback_t::trigger( list, this, state );
+}
+
 // action_t::reset ==========================================================
 
 void action_t::reset()
@@ -2297,6 +2503,16 @@ void action_t::reset()
   }
 }
 
+// action_t::collect_expressions ============================================
+
+void action_t::collect_expressions( std::vector<expr_t**>& exprs )
+{
+  exprs.push_back( &if_expr );
+  exprs.push_back( &target_if_expr );
+  exprs.push_back( &interrupt_if_expr );
+  exprs.push_back( &early_chain_if_expr );
+}
+
 // action_t::cancel =========================================================
 
 void action_t::cancel()
@@ -3263,6 +3479,8 @@ void action_t::consolidate_snapshot_flags()
   if ( tick_action    ) snapshot_flags |= tick_action    -> snapshot_flags;
   if ( execute_action ) snapshot_flags |= execute_action -> snapshot_flags;
   if ( impact_action  ) snapshot_flags |= impact_action  -> snapshot_flags;
+
+  state_copy_flags = partial_snapshot ? snapshot_flags | update_flags : ~0U;
 }
 
 timespan_t action_t::composite_dot_duration( const action_state_t* s ) const
@@ -3372,6 +3590,7 @@ void action_t::trigger_dot( action_state_t* s )
   dot -> current_action = this;
   dot -> max_stack = dot_max_stack;
 
+  dot -> touch();
   if ( ! dot -> state ) dot -> state = get_state();
   dot -> state -> copy_state( s );
 
@@ -3655,10 +3874,7 @@ void action_t::reschedule_queue_event()
   }
   else
   {
-    bool off_gcd = debug_cast<queued_action_execute_event_t*>( queue_event ) -> off_gcd;
-
-    event_t::cancel( queue_event );
-    queue_event = make_event<queued_action_execute_event_t>( *sim, this, new_queue_delay, off_gcd );
+    queue_event -> adjust( new_queue_delay );
   }
 }
 
@@ -5,6 +5,134 @@
 
 #include "simulationcraft.hpp"
 
+namespace
+{
+// Current state arena of the thread
+SC_THREAD_LOCAL state_arena_t* current_state_arena = nullptr;
+
+// Allocation header of action states, records the arena pool the state came from. Sized and
+// aligned so that the state following it stays suitably aligned.
+union state_header_t
+{
+  state_arena_t::pool_t* pool;
+  long double align_ld;
+  double align_d;
+  void* align_p;
+};
+}
+
+// state_arena_t::~state_arena_t ============================================
+
+state_arena_t::~state_arena_t()
+{
+  for ( void* chunk : chunks )
+  {
+    ::operator delete( chunk );
+  }
+}
+
+// state_arena_t::current ===================================================
+
+state_arena_t*& state_arena_t::current()
+{
+  return current_state_arena;
+}
+
+// state_arena_t::allocate ==================================================
+
+void* state_arena_t::allocate( std::size_t size, pool_t*& pool )
+{
+  // Round the object up so consecutive objects in a chunk stay aligned
+  size = ( size + sizeof( state_header_t ) - 1 ) / sizeof( state_header_t ) * sizeof( state_header_t );
+
+  pool = nullptr;
+  for ( const auto& p : pools )
+  {
+    if ( p->size == size )
+    {
+      pool = p.get();
+      break;
+    }
+  }
+
+  if ( !pool )
+  {
+    pools.push_back( std::unique_ptr<pool_t>( new pool_t( size ) ) );
+    pool = pools.back().get();
+  }
+
+  if ( pool->free_list )
+  {
+    void* p         = pool->free_list;
+    pool->free_list = *static_cast<void**>( p );
+    return p;
+  }
+
+  if ( pool->next == pool->end )
+  {
+    char* chunk = static_cast<char*>( ::operator new( size * CHUNK_OBJECTS ) );
+    chunks.push_back( chunk );
+    pool->next = chunk;
+    pool->end  = chunk + size * CHUNK_OBJECTS;
+  }
+
+  void* p = pool->next;
+  pool->next += size;
+
+  return p;
+}
+
+// state_arena_t::release ===================================================
+
+void state_arena_t::release( pool_t* pool, void* p )
+{
+  *static_cast<void**>( p ) = pool->free_list;
+  pool->free_list           = p;
+}
+
+// action_state_t::operator new =============================================
+
+void* action_state_t::operator new( std::size_t size )
+{
+  state_arena_t::pool_t* pool = nullptr;
+  std::size_t total           = size + sizeof( state_header_t );
+
+  void* p;
+  if ( state_arena_t* arena = state_arena_t::current() )
+  {
+    p = arena->allocate( total, pool );
+  }
+  else
+  {
+    p = ::operator new( total );
+  }
+
+  state_header_t* header = static_cast<state_header_t*>( p );
+  header->pool           = pool;
+
+  return header + 1;
+}
+
+// action_state_t::operator delete ==========================================
+
+void action_state_t::operator delete( void* p )
+{
+  if ( !p )
+  {
+    return;
+  }
+
+  state_header_t* header = static_cast<state_header_t*>( p ) - 1;
+  if ( header->pool )
+  {
+    state_arena_t::release( header->pool, header );
+  }
+  else
+  {
+    ::operator delete( header );
+  }
+}
+
 action_state_t* action_t::get_state( const action_state_t* other )
 {
   action_state_t* s = nullptr;
@@ -16,6 +144,7 @@ action_state_t* action_t::get_state( const action_state_t* other )
   }
   else
   {
+    state_arena_t::scope_t arena_scope( sim->state_arena );
     s = new_state();
   }
 
@@ -91,6 +220,15 @@ void action_state_t::copy_state( const action_state_t* o )
   result_amount      = o->result_amount;
   blocked_amount     = o->blocked_amount;
   self_absorb_amount = o->self_absorb_amount;
+
+  // Partial snapshot, only copy the snapshot fields the action declared it uses
+  unsigned flags = action ? action->state_copy_flags : ~0U;
+  if ( flags != ~0U )
+  {
+    copy_snapshot( o, flags );
+    return;
+  }
+
   haste              = o->haste;
   crit_chance        = o->crit_chance;
   target_crit_chance = o->target_crit_chance;
@@ -111,6 +249,43 @@ void action_state_t::copy_state( const action_state_t* o )
   target_armor                    = o->target_armor;
 }
 
+void action_state_t::copy_snapshot( const action_state_t* o, unsigned flags )
+{
+  if ( flags & STATE_HASTE )
+    haste = o->haste;
+  if ( flags & STATE_CRIT )
+    crit_chance = o->crit_chance;
+  if ( flags & STATE_TGT_CRIT )
+    target_crit_chance = o->target_crit_chance;
+  if ( flags & STATE_AP )
+    attack_power = o->attack_power;
+  if ( flags & STATE_SP )
+    spell_power = o->spell_power;
+
+  if ( flags & STATE_VERSATILITY )
+    versatility = o->versatility;
+  if ( flags & STATE_MUL_DA )
+    da_multiplier = o->da_multiplier;
+  if ( flags & STATE_MUL_TA )
+    ta_multiplier = o->ta_multiplier;
+  if ( flags & STATE_MUL_PERSISTENT )
+    persistent_multiplier = o->persistent_multiplier;
+  if ( flags & STATE_MUL_PET )
+    pet_multiplier = o->pet_multiplier;
+
+  if ( flags & STATE_TGT_MUL_DA )
+    target_da_multiplier = o->target_da_multiplier;
+  if ( flags & STATE_TGT_MUL_TA )
+    target_ta_multiplier = o->target_ta_multiplier;
+
+  if ( flags & STATE_TGT_MITG_DA )
+    target_mitigation_da_multiplier = o->target_mitigation_da_multiplier;
+  if ( flags & STATE_TGT_MITG_TA )
+    target_mitigation_ta_multiplier = o->target_mitigation_ta_multiplier;
+  if ( flags & STATE_TGT_ARMOR )
+    target_armor = o->target_armor;
+}
+
 action_state_t::action_state_t( action_t* a, player_t* t )
   : next( nullptr ),
     action( a ),
@@ -303,9 +303,8 @@ void attack_t::reschedule_auto_attack( double old_swing_haste )
     return;
   }
 
-  // Note that if attack -> swing_haste() > old_swing_haste, this could
-  // probably be handled by rescheduling, but the code is slightly simpler if
-  // we just cancel the event and make a new one.
+  // The remaining fraction of the swing is kept at the new attack speed. Slower swings are
+  // rescheduled lazily, faster ones are moved earlier in place.
   if ( execute_event && execute_event->remains() > timespan_t::zero() )
   {
     timespan_t time_to_hit = execute_event->occurs() - sim->current_time();
@@ -331,8 +330,8 @@ void attack_t::reschedule_auto_attack( double old_swing_haste )
       execute_event->reschedule( new_time_to_hit );
     else
     {
-      event_t::cancel( execute_event );
-      execute_event = start_action_execute_event( new_time_to_hit );
+      // The swing drops any carried state, the same as a newly scheduled swing
+      adjust_execute_event( new_time_to_hit, false );
     }
   }
 }
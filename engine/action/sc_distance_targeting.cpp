@@ -43,15 +43,83 @@ bool action_t::execute_targeting( action_t* action ) const
   return true;
 }
 
+namespace
+{
+// Relative slack added to spatial index queries, covering the error of util::approx_sqrt in the
+// exact distance checks
+const double QUERY_SLACK = 1.01;
+}
+
+// action_t::distance_targeting_candidates ==================================
+
+const spatial_index_t::query_t* action_t::distance_targeting_candidates() const
+{
+  spatial_index_t& index = sim->spatial_index;
+  if ( !index.active() )
+    return nullptr;
+
+  double x, y, r;
+  if ( radius > 0 && range > 0 )
+  {
+    if ( ground_aoe && parent_dot && parent_dot->is_ticking() )
+    {
+      x = parent_dot->state->original_x;
+      y = parent_dot->state->original_y;
+      r = radius + index.max_combat_reach;
+    }
+    else if ( ground_aoe && execute_state )
+    {
+      x = execute_state->original_x;
+      y = execute_state->original_y;
+      r = radius + index.max_combat_reach;
+    }
+    else
+    {
+      x = target->x_position;
+      y = target->y_position;
+      r = radius;
+    }
+  }
+  else if ( radius > 0 )
+  {
+    x = player->x_position;
+    y = player->y_position;
+    r = radius + index.max_combat_reach;
+  }
+  else if ( range > 0 )
+  {
+    x = player->x_position;
+    y = player->y_position;
+    r = range + index.max_combat_reach;
+  }
+  else
+  {
+    return nullptr;
+  }
+
+  return &index.query( x, y, r * QUERY_SLACK );
+}
+
 std::vector<player_t*> action_t::targets_in_range_list(
     std::vector<player_t*>& tl ) const
 {
+  const spatial_index_t::query_t* candidates = nullptr;
+  if ( range > 0.0 && sim->spatial_index.active() )
+  {
+    candidates = &sim->spatial_index.query( player->x_position, player->y_position,
+                                            range * QUERY_SLACK );
+  }
+
   size_t i = tl.size();
   while ( i > 0 )
   {
     i--;
     player_t* target_ = tl[ i ];
-    if ( range > 0.0 && player->get_player_distance( *target_ ) > range )
+    if ( candidates && !candidates->contains( target_ ) )
+    {
+      tl.erase( tl.begin() + i );
+    }
+    else if ( range > 0.0 && player->get_player_distance( *target_ ) > range )
     {
       tl.erase( tl.begin() + i );
     }
@@ -70,6 +138,9 @@ std::vector<player_t*> action_t::check_distance_targeting(
 {
   if ( sim -> distance_targeting_enabled )
   {
+    // Targets outside the cells around the area of the action are out of range
+    const spatial_index_t::query_t* candidates = distance_targeting_candidates();
+
     size_t i = tl.size();
     while ( i > 0 )
     {
@@ -91,6 +162,10 @@ std::vector<player_t*> action_t::check_distance_targeting(
         {
           tl.erase( tl.begin() + i );
         }
+        else if ( candidates && !candidates->contains( t ) )
+        {
+          tl.erase( tl.begin() + i );
+        }
         else if ( radius > 0 && range > 0 )
         {  // Abilities with range/radius radiate from the target.
           if ( ground_aoe && parent_dot && parent_dot->is_ticking() )
@@ -149,6 +224,30 @@ std::vector<player_t*> action_t::check_distance_targeting(
   return tl;
 }
 
+bool action_t::target_memo_valid( const target_memo_t& memo ) const
+{
+  // The evaluation rolls for false negatives (of the action, or its sync action in ready())
+  if ( false_negative_pct() > 0 || ( sync_action && sync_action->false_negative_pct() > 0 ) )
+    return false;
+
+  return memo.iteration == sim->current_iteration &&
+         memo.epoch == sim->state_epoch &&
+         memo.variables == player->variable_version &&
+         memo.resources == player->resources.version &&
+         memo.original_target == target;
+}
+
+void action_t::update_target_memo( target_memo_t& memo, player_t* original_target,
+                                   player_t* result )
+{
+  memo.iteration       = sim->current_iteration;
+  memo.epoch           = sim->state_epoch;
+  memo.variables       = player->variable_version;
+  memo.resources       = player->resources.version;
+  memo.original_target = original_target;
+  memo.result          = result;
+}
+
 player_t* action_t::select_target_if_target()
 {
   if ( target_if_mode == TARGET_IF_NONE )
@@ -156,6 +255,20 @@ player_t* action_t::select_target_if_target()
     return nullptr;
   }
 
+  if ( target_memo_valid( target_if_memo ) )
+  {
+    return target_if_memo.result;
+  }
+
+  player_t* original_target = target;
+  player_t* result          = find_target_if_target();
+  update_target_memo( target_if_memo, original_target, result );
+
+  return result;
+}
+
+player_t* action_t::find_target_if_target()
+{
   if ( target_list().size() == 1 )
   {
     // If first is used, don't return a valid target unless the target_if
@@ -168,18 +281,21 @@ player_t* action_t::select_target_if_target()
     return target;
   }
 
-  std::vector<player_t*> master_list;
+  // Copy the candidates into a reused scratch list, as evaluating target_if may rebuild the target
+  // cache the list refers to.
+  std::vector<player_t*>& master_list = target_if_list;
   if ( sim->distance_targeting_enabled )
   {
-    if ( !target_cache.is_valid )
+    if ( !target_cache.is_valid || target_cache.spatial_version != sim->spatial_index.version )
     {
       available_targets( target_cache.list );
-      master_list           = targets_in_range_list( target_cache.list );
-      target_cache.is_valid = true;
+      master_list                  = targets_in_range_list( target_cache.list );
+      target_cache.is_valid        = true;
+      target_cache.spatial_version = sim->spatial_index.version;
     }
     else
     {
-      master_list = target_cache.list;
+      master_list.assign( target_cache.list.begin(), target_cache.list.end() );
     }
     if ( sim->log )
       sim->out_debug.printf( "%s Number of targets found in range - %.3f",
@@ -190,7 +306,8 @@ player_t* action_t::select_target_if_target()
   }
   else
   {
-    master_list = target_list();
+    const std::vector<player_t*>& tl = target_list();
+    master_list.assign( tl.begin(), tl.end() );
   }
 
   player_t* original_target = target;
@@ -295,6 +412,19 @@ double player_t::get_player_distance( const player_t& target ) const
     return current.distance;
 }
 
+// player_t::set_position ======================================================
+
+void player_t::set_position( double x, double y )
+{
+  x_position = x;
+  y_position = y;
+
+  if ( sim->distance_targeting_enabled )
+  {
+    sim->spatial_index.update( this );
+  }
+}
+
 // player_t::get_ground_aoe_distance ===========================================
 
 double player_t::get_ground_aoe_distance( action_state_t& a ) const
@@ -309,7 +439,125 @@ void player_t::init_distance_targeting()
   if ( !sim->distance_targeting_enabled )
     return;
 
-  x_position = -1 * base.distance;
+  set_position( -1 * base.distance, y_position );
+}
+
+// Spatial index ==============================================================
+
+const spatial_index_t::cell_key_t spatial_index_t::NO_CELL;
+
+spatial_index_t::spatial_index_t()
+  : cell_size( 10.0 ), version( 0 ), max_combat_reach( 0 ), query_version( 0 )
+{
+}
+
+bool spatial_index_t::query_t::contains( const player_t* actor ) const
+{
+  return actor->actor_index < member.size() && member[ actor->actor_index ];
+}
+
+int spatial_index_t::cell( double coordinate ) const
+{
+  return static_cast<int>( std::floor( coordinate / cell_size ) );
+}
+
+spatial_index_t::cell_key_t spatial_index_t::key( int cx, int cy )
+{
+  return ( static_cast<cell_key_t>( cx ) << 32 ) | static_cast<uint32_t>( cy );
+}
+
+// spatial_index_t::update ====================================================
+
+void spatial_index_t::update( player_t* actor )
+{
+  // Every move changes distances, so cached target lists and queries are stale
+  version++;
+
+  if ( !active() )
+    return;
+
+  if ( actor_cells.size() <= actor->actor_index )
+  {
+    actor_cells.resize( actor->actor_index + 1, NO_CELL );
+  }
+
+  max_combat_reach = std::max( max_combat_reach, actor->combat_reach );
+
+  cell_key_t new_cell = key( cell( actor->x_position ), cell( actor->y_position ) );
+  cell_key_t& old_cell = actor_cells[ actor->actor_index ];
+  if ( new_cell == old_cell )
+    return;
+
+  if ( old_cell != NO_CELL )
+  {
+    std::vector<player_t*>& actors = cells[ old_cell ];
+    actors.erase( std::find( actors.begin(), actors.end(), actor ) );
+  }
+
+  cells[ new_cell ].push_back( actor );
+  old_cell = new_cell;
+}
+
+// spatial_index_t::query =====================================================
+
+const spatial_index_t::query_t& spatial_index_t::query( double x, double y, double radius )
+{
+  if ( query_version != version )
+  {
+    queries.clear();
+    query_version = version;
+  }
+
+  for ( const auto& q : queries )
+  {
+    if ( q->x == x && q->y == y && q->radius == radius )
+      return *q;
+  }
+
+  std::unique_ptr<query_t> q( new query_t() );
+  q->x      = x;
+  q->y      = y;
+  q->radius = radius;
+  q->member.resize( actor_cells.size() );
+
+  int x0 = cell( x - radius ), x1 = cell( x + radius );
+  int y0 = cell( y - radius ), y1 = cell( y + radius );
+
+  // Large areas cover more cells than there are occupied ones, scan the occupied cells instead
+  if ( static_cast<double>( x1 - x0 + 1 ) * ( y1 - y0 + 1 ) > cells.size() )
+  {
+    for ( const auto& c : cells )
+    {
+      int cx = static_cast<int>( c.first >> 32 );
+      int cy = static_cast<int32_t>( c.first & 0xFFFFFFFF );
+      if ( cx >= x0 && cx <= x1 && cy >= y0 && cy <= y1 )
+        add_cell( *q, c.first );
+    }
+  }
+  else
+  {
+    for ( int cx = x0; cx <= x1; ++cx )
+    {
+      for ( int cy = y0; cy <= y1; ++cy )
+        add_cell( *q, key( cx, cy ) );
+    }
+  }
+
+  queries.push_back( std::move( q ) );
+  return *queries.back();
+}
+
+void spatial_index_t::add_cell( query_t& q, cell_key_t k ) const
+{
+  auto it = cells.find( k );
+  if ( it == cells.end() )
+    return;
+
+  for ( player_t* actor : it->second )
+  {
+    q.actors.push_back( actor );
+    q.member[ actor->actor_index ] = 1;
+  }
 }
 
 // Generic helper functions ==================================================
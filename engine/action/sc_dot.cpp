@@ -17,9 +17,12 @@ dot_t::dot_t( const std::string& n, player_t* t, player_t* s )
     extended_time( timespan_t::zero() ),
     reduced_time( timespan_t::zero() ),
     stack( 0 ),
+    scheduled_tick( timespan_t::min() ),
+    scheduled_tick_id( 0 ),
     tick_event( nullptr ),
     end_event( nullptr ),
     last_tick_factor( -1.0 ),
+    touched( false ),
     target( t ),
     source( s ),
     current_action( nullptr ),
@@ -56,7 +59,7 @@ void dot_t::extend_duration( timespan_t extra_seconds,
     state_flags = current_action->snapshot_flags;
 
   // Make sure this DoT is still ticking......
-  assert( tick_event );
+  assert( tick_scheduled() );
   assert( state );
   current_action->snapshot_internal(
       state, state_flags,
@@ -98,7 +101,7 @@ void dot_t::reduce_duration( timespan_t remove_seconds, uint32_t state_flags )
     state_flags = current_action->snapshot_flags;
 
   // Make sure this DoT is still ticking......
-  assert( tick_event );
+  assert( tick_scheduled() );
   assert( state );
   current_action->snapshot_internal(
       state, state_flags,
@@ -165,7 +168,7 @@ void dot_t::reset()
   if ( ticking )
     source->remove_active_dot( state->action->internal_id );
 
-  event_t::cancel( tick_event );
+  cancel_tick();
   event_t::cancel( end_event );
   time_to_tick     = timespan_t::zero();
   ticking          = false;
@@ -181,6 +184,17 @@ void dot_t::reset()
     action_state_t::release( state );
 }
 
+/* True if the dot is in the state reset() puts it in
+ */
+bool dot_t::is_reset() const
+{
+  return !ticking && !tick_scheduled() && !end_event && current_tick == 0 &&
+         stack == 0 && extended_time == timespan_t::zero() &&
+         miss_time == timespan_t::min() && last_start == timespan_t::min() &&
+         current_duration == timespan_t::min() && last_tick_factor == -1.0 &&
+         !state;
+}
+
 /* Trigger a dot with given duration.
  * Main function to start/refresh a dot
  */
@@ -189,6 +203,7 @@ void dot_t::trigger( timespan_t duration )
   assert( duration > timespan_t::zero() &&
           "Dot Trigger with duration <= 0 seconds." );
 
+  touch();
   current_tick     = 0;
   extended_time    = timespan_t::zero();
   last_tick_factor = 1.0;
@@ -229,6 +244,7 @@ void dot_t::copy( player_t* other_target, dot_copy_e copy_type ) const
     return;
 
   dot_t* other_dot = current_action->get_dot( other_target );
+  other_dot->touch();
   // Copied dot, with the DOT_COPY_START method cancels the ongoing dot on the
   // target, and then starts a fresh dot on it with the source dot's (copied)
   // state
@@ -278,11 +294,11 @@ void dot_t::copy( player_t* other_target, dot_copy_e copy_type ) const
       new_duration = current_action->calculate_dot_refresh_duration(
           other_dot, remains() );
 
-      assert( other_dot->end_event && other_dot->tick_event );
+      assert( other_dot->end_event && other_dot->tick_scheduled() );
 
       // Cancel target's ongoing events, we are about to re-do them
       event_t::cancel( other_dot->end_event );
-      event_t::cancel( other_dot->tick_event );
+      other_dot->cancel_tick();
     }
     // No target dot ticking, just copy the source's remaining time
     else
@@ -305,8 +321,8 @@ void dot_t::copy( player_t* other_target, dot_copy_e copy_type ) const
     // source's ongoing remaining tick time, since we are copying the ongoing
     // tick too
     timespan_t computed_tick_duration = new_duration;
-    if ( tick_event && tick_event->remains() > new_duration )
-      computed_tick_duration += time_to_tick - tick_event->remains();
+    if ( tick_scheduled() && tick_remains() > new_duration )
+      computed_tick_duration += time_to_tick - tick_remains();
 
     // Aand then adjust some things for ease-of-use for now. The copied dot has
     // its current tick reset to 0, and it's last start time is set to current
@@ -338,19 +354,19 @@ void dot_t::copy( player_t* other_target, dot_copy_e copy_type ) const
     // time. Tick time will be recalculated on the next tick, implicitly
     // syncing it to the source's tick time.
     timespan_t tick_time;
-    if ( tick_event )
-      tick_time = tick_event->remains();
+    if ( tick_scheduled() )
+      tick_time = tick_remains();
     else
       tick_time = other_dot->current_action->tick_time( other_dot->state );
 
-    other_dot->tick_event =
-        make_event<dot_tick_event_t>( sim, other_dot, tick_time );
+    other_dot->schedule_tick_event( tick_time );
   }
 }
 
 // For duplicating a DoT (creating a 2nd instance) on one target.
 void dot_t::copy( dot_t* other_dot ) const
 {
+  other_dot->touch();
   // Shared initialize for the target dot state, independent of the copying
   // method
   action_state_t* target_state = nullptr;
@@ -382,11 +398,11 @@ void dot_t::copy( dot_t* other_dot ) const
     new_duration =
         current_action->calculate_dot_refresh_duration( other_dot, remains() );
 
-    assert( other_dot->end_event && other_dot->tick_event );
+    assert( other_dot->end_event && other_dot->tick_scheduled() );
 
     // Cancel target's ongoing events, we are about to re-do them
     event_t::cancel( other_dot->end_event );
-    event_t::cancel( other_dot->tick_event );
+    other_dot->cancel_tick();
   }
   // No target dot ticking, just copy the source's remaining time
   else
@@ -409,8 +425,8 @@ void dot_t::copy( dot_t* other_dot ) const
   // source's ongoing remaining tick time, since we are copying the ongoing
   // tick too
   timespan_t computed_tick_duration = new_duration;
-  if ( tick_event && tick_event->remains() > new_duration )
-    computed_tick_duration += time_to_tick - tick_event->remains();
+  if ( tick_scheduled() && tick_remains() > new_duration )
+    computed_tick_duration += time_to_tick - tick_remains();
 
   // Aand then adjust some things for ease-of-use for now. The copied dot has
   // its current tick reset to 0, and it's last start time is set to current
@@ -441,12 +457,12 @@ void dot_t::copy( dot_t* other_dot ) const
   // time. Tick time will be recalculated on the next tick, implicitly
   // syncing it to the source's tick time.
   timespan_t tick_time;
-  if ( tick_event )
-    tick_time = tick_event->remains();
+  if ( tick_scheduled() )
+    tick_time = tick_remains();
   else
     tick_time = other_dot->current_action->tick_time( other_dot->state );
 
-  other_dot->tick_event = make_event<dot_tick_event_t>( sim, other_dot, tick_time );
+  other_dot->schedule_tick_event( tick_time );
 }
 
 // dot_t::create_expression =================================================
@@ -578,6 +594,9 @@ expr_t* dot_t::create_expression( action_t* action, const std::string& name_str,
   }
   else if ( name_str == "remains" )
   {
+    if ( !dynamic )
+      return make_state_expr<expr_ref_t::REF_DOT_REMAINS>( "dot_remains", *this );
+
     struct remains_expr_t : public dot_expr_t
     {
       remains_expr_t( dot_t* d, action_t* a, bool dynamic )
@@ -663,7 +682,7 @@ expr_t* dot_t::create_expression( action_t* action, const std::string& name_str,
       virtual double evaluate() override
       {
         return dot()->is_ticking()
-                   ? dot()->tick_event->remains().total_seconds()
+                   ? dot()->time_to_next_tick().total_seconds()
                    : 0;
       }
     };
@@ -686,6 +705,9 @@ expr_t* dot_t::create_expression( action_t* action, const std::string& name_str,
   }
   else if ( name_str == "ticking" )
   {
+    if ( !dynamic )
+      return make_state_expr<expr_ref_t::REF_DOT_TICKING>( "dot_ticking", *this );
+
     struct ticking_expr_t : public dot_expr_t
     {
       ticking_expr_t( dot_t* d, action_t* a, bool dynamic )
@@ -857,7 +879,18 @@ timespan_t dot_t::time_to_next_tick() const
     return timespan_t::zero();
   if ( !ticking )
     return timespan_t::zero();
-  return tick_event->remains();
+  return tick_remains();
+}
+
+/* Remaining time to the pending tick of the dot
+ */
+timespan_t dot_t::tick_remains() const
+{
+  if ( tick_event )
+    return tick_event->remains();
+  if ( scheduled_tick != timespan_t::min() )
+    return scheduled_tick - sim.current_time();
+  return timespan_t::zero();
 }
 
 /* Returns the ticks left based on the current estimated number of max ticks
@@ -1002,7 +1035,7 @@ void dot_t::schedule_tick()
   last_tick_factor =
       current_action->last_tick_factor( this, base_tick_time, remains() );
 
-  tick_event = make_event<dot_tick_event_t>( sim, this, time_to_tick );
+  schedule_tick_event( time_to_tick );
 
   if ( current_action->channeled )
   {
@@ -1039,6 +1072,7 @@ void dot_t::schedule_tick()
 
 void dot_t::start( timespan_t duration )
 {
+  touch();
   current_duration = duration;
   last_start       = sim.current_time();
 
@@ -1064,7 +1098,7 @@ void dot_t::start( timespan_t duration )
   // Only schedule a tick if thre's enough time to tick at least once.
   // Otherwise, next tick is the last tick, and the end event will handle it
   if ( current_duration <= time_to_tick )
-    event_t::cancel( tick_event );
+    cancel_tick();
 }
 
 /* Precondition: ticking == true
@@ -1111,10 +1145,10 @@ void dot_t::refresh( timespan_t duration )
   // that a specialized dot handling cancels the ticker when there's no time to
   // tick another one (before the periodic effect ends). This is for example
   // used in the Rogue module to implement Sinister Calling.
-  if ( !tick_event )
+  if ( !tick_scheduled() )
   {
     assert( !current_action->channeled );
-    tick_event = make_event<dot_tick_event_t>( sim, this, remaining_duration );
+    schedule_tick_event( remaining_duration );
   }
 }
 
@@ -1213,7 +1247,7 @@ void dot_t::adjust( double coefficient )
 
   sim_t* sim = current_action->sim;
 
-  timespan_t new_tick_remains = tick_event->remains() * coefficient;
+  timespan_t new_tick_remains = tick_remains() * coefficient;
   timespan_t new_dot_remains  = end_event->remains() * coefficient;
   timespan_t new_duration     = current_duration * coefficient;
 
@@ -1224,18 +1258,238 @@ void dot_t::adjust( double coefficient )
         "%.3f, ends=%.3f -> %.3f",
         current_action->player->name(), current_action->name(), target->name(),
         current_duration.total_seconds(), new_duration.total_seconds(),
-        tick_event->occurs().total_seconds(),
+        ( sim->current_time() + tick_remains() ).total_seconds(),
         ( sim->current_time() + new_tick_remains ).total_seconds(),
         end_event->occurs().total_seconds(),
         ( sim->current_time() + new_dot_remains ).total_seconds() );
   }
 
-  event_t::cancel( tick_event );
+  cancel_tick();
   event_t::cancel( end_event );
 
   current_duration = new_duration;
   time_to_tick     = time_to_tick * coefficient;
-  tick_event       = make_event<dot_tick_event_t>( *sim, this, new_tick_remains );
+  schedule_tick_event( new_tick_remains );
   //end_event        = new ( *sim ) dot_end_event_t( this, new_dot_remains );
   end_event = make_event<dot_end_event_t>(*sim, this, new_dot_remains );
 }
+
+void dot_t::schedule_tick_event( timespan_t time_to_tick )
+{
+  if ( source->dot_tick_scheduler.active )
+  {
+    source->dot_tick_scheduler.schedule( this, time_to_tick );
+  }
+  else
+  {
+    tick_event = make_event<dot_tick_event_t>( sim, this, time_to_tick );
+  }
+}
+
+void dot_t::cancel_tick()
+{
+  event_t::cancel( tick_event );
+  if ( scheduled_tick != timespan_t::min() )
+  {
+    source->dot_tick_scheduler.cancel( this );
+  }
+}
+
+void dot_t::reschedule_tick( timespan_t new_time_to_tick )
+{
+  // Tick events can only be moved later in place
+  if ( tick_event && new_time_to_tick >= tick_event->remains() )
+  {
+    tick_event->reschedule( new_time_to_tick );
+    return;
+  }
+
+  cancel_tick();
+  schedule_tick_event( new_time_to_tick );
+}
+
+/* Execute the pending tick of the dot, and schedule the next one
+ */
+void dot_t::execute_tick()
+{
+  current_tick++;
+
+  if ( current_action->channeled && current_action->action_skill < 1.0 &&
+       remains() >= current_action->tick_time( state ) )
+  {
+    if ( sim.rng().roll( std::max( 0.0, current_action->action_skill -
+                                            current_action->player->current.skill_debuff ) ) )
+    {
+      tick();
+    }
+  }
+  else  // No skill-check required
+  {
+    tick();
+  }
+
+  // Some dots actually cancel themselves mid-tick. If this happens, we presume
+  // that the cancel has been "proper", and just stop event execution here, as
+  // the dot no longer exists.
+  if ( !is_ticking() )
+    return;
+
+  if ( !current_action->consume_cost_per_tick( *this ) )
+  {
+    return;
+  }
+
+  if ( channel_interrupt() )
+  {
+    return;
+  }
+
+  // continue ticking
+  schedule_tick();
+}
+
+// ==========================================================================
+// DoT Tick Scheduler
+// ==========================================================================
+
+namespace
+{
+struct dot_tick_batch_event_t : public event_t
+{
+  dot_tick_scheduler_t* scheduler;
+
+  dot_tick_batch_event_t( dot_tick_scheduler_t* s, timespan_t time_to_tick )
+    : event_t( *s->player, time_to_tick ), scheduler( s )
+  {
+  }
+
+  const char* name() const override
+  {
+    return "DoT Tick Batch";
+  }
+
+  void execute() override
+  {
+    scheduler->event = nullptr;
+    scheduler->execute();
+  }
+};
+
+// Earliest tick on top of the heap, ties broken by scheduling order
+bool later_tick( const dot_tick_scheduler_t::entry_t& l, const dot_tick_scheduler_t::entry_t& r )
+{
+  return l.time != r.time ? l.time > r.time : l.id > r.id;
+}
+}  // unnamed namespace
+
+// dot_tick_scheduler_t::valid ==============================================
+
+// Canceled and moved ticks leave their entry in the heap, only the latest entry of a dot is valid
+bool dot_tick_scheduler_t::valid( const entry_t& e )
+{
+  return e.dot->scheduled_tick_id == e.id;
+}
+
+// dot_tick_scheduler_t::schedule ===========================================
+
+void dot_tick_scheduler_t::schedule( dot_t* d, timespan_t time_to_tick )
+{
+  sim_t* sim = player->sim;
+
+  if ( sim->debug )
+    sim->out_debug.printf( "New DoT Tick: %s %s %d-of-%d %.4f", player->name(), d->name(),
+                           d->current_tick + 1, d->num_ticks, time_to_tick.total_seconds() );
+
+  // A new entry supersedes any pending one of the dot
+  entry_t e;
+  e.time = sim->current_time() + time_to_tick;
+  e.id   = ++next_id;
+  e.dot  = d;
+
+  d->scheduled_tick    = e.time;
+  d->scheduled_tick_id = e.id;
+
+  heap.push_back( e );
+  std::push_heap( heap.begin(), heap.end(), later_tick );
+
+  if ( !event || event->occurs() > e.time )
+  {
+    event_t::cancel( event );
+    event = make_event<dot_tick_batch_event_t>( *sim, this, time_to_tick );
+  }
+}
+
+// dot_tick_scheduler_t::cancel =============================================
+
+void dot_tick_scheduler_t::cancel( dot_t* d )
+{
+  // The heap entry is dropped when it reaches the top of the heap
+  d->scheduled_tick    = timespan_t::min();
+  d->scheduled_tick_id = 0;
+}
+
+// dot_tick_scheduler_t::execute ============================================
+
+void dot_tick_scheduler_t::execute()
+{
+  timespan_t now = player->sim->current_time();
+
+  batch.clear();
+  while ( !heap.empty() && heap.front().time <= now )
+  {
+    if ( valid( heap.front() ) )
+      batch.push_back( heap.front() );
+    std::pop_heap( heap.begin(), heap.end(), later_tick );
+    heap.pop_back();
+  }
+
+  for ( size_t i = 0; i < batch.size(); ++i )
+  {
+    const entry_t& e = batch[ i ];
+    // An earlier tick in the batch may have canceled or moved this one
+    if ( !valid( e ) )
+      continue;
+
+    e.dot->scheduled_tick    = timespan_t::min();
+    e.dot->scheduled_tick_id = 0;
+    e.dot->execute_tick();
+  }
+
+  schedule_event();
+}
+
+// dot_tick_scheduler_t::schedule_event =====================================
+
+void dot_tick_scheduler_t::schedule_event()
+{
+  while ( !heap.empty() && !valid( heap.front() ) )
+  {
+    std::pop_heap( heap.begin(), heap.end(), later_tick );
+    heap.pop_back();
+  }
+
+  if ( heap.empty() )
+  {
+    event_t::cancel( event );
+    return;
+  }
+
+  sim_t* sim      = player->sim;
+  timespan_t time = heap.front().time;
+  if ( event && event->occurs() == time )
+  {
+    return;
+  }
+
+  event_t::cancel( event );
+  event = make_event<dot_tick_batch_event_t>( *sim, this, time - sim->current_time() );
+}
+
+// dot_tick_scheduler_t::reset ==============================================
+
+void dot_tick_scheduler_t::reset()
+{
+  heap.clear();
+  batch.clear();
+  event = nullptr;
+}
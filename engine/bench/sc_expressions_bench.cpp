@@ -0,0 +1,301 @@
+// ==========================================================================
+// Dedmonwakeen's Raid DPS/TPS Simulator.
+// Send questions to natehieter@gmail.com
+// ==========================================================================
+
+// Expression engine microbenchmark
+//
+// Builds a set of representative expressions, one per expression node type, against a synthetic
+// actor, and measures evaluations per second for unoptimized expression trees, optimized
+// expression trees, and compiled expressions. Any profiles given on the command line are replayed
+// as a corpus: the action list conditions (if=) of every actor in the profiles are built in each of
+// the three forms and evaluated round-robin.
+//
+// Usage: simc_bench_expressions [bench_evaluations=N] [profile.simc ...] [option=value ...]
+//
+// Options prefixed with bench_ are consumed by the benchmark, everything else is passed on to the
+// simulator as is. The Makefile target bench_expressions_corpus replays the profiles in
+// BENCH_PROFILES.
+
+#include "simulationcraft.hpp"
+
+namespace { // anonymous namespace ==========================================
+
+// Synthetic actor for the node type benchmarks
+const char* synthetic_actor[] = {
+  "warrior=Bench_Warrior",
+  "spec=fury",
+  "level=110",
+  "race=orc",
+  "actions=auto_attack",
+  "actions+=/bloodthirst",
+  "actions+=/raging_blow",
+  "actions+=/whirlwind",
+};
+
+// Representative expressions, one per node type
+struct node_type_expr_t
+{
+  const char* type;
+  const char* expression;
+};
+
+const node_type_expr_t node_type_exprs[] = {
+  { "constant",           "1"                                                                },
+  { "resource reference", "rage"                                                             },
+  { "resource function",  "rage.deficit"                                                     },
+  { "player function",    "target.health.pct"                                                },
+  { "time",               "time"                                                             },
+  { "buff state",         "buff.bloodlust.up"                                                },
+  { "cooldown state",     "cooldown.bloodthirst.remains"                                     },
+  { "unary operator",     "!buff.bloodlust.up"                                               },
+  { "arithmetic",         "rage*2+target.health.pct"                                         },
+  { "comparison",         "rage>=50"                                                         },
+  { "logical",            "buff.bloodlust.up&rage>=50|target.health.pct<20"                  },
+  { "representative",     "(buff.bloodlust.up|target.health.pct<20)&rage>=60&"
+                          "cooldown.bloodthirst.remains<1.5&!buff.bloodlust.down"            },
+};
+
+enum bench_mode_e
+{
+  MODE_TREE = 0,
+  MODE_OPTIMIZED,
+  MODE_COMPILED,
+  MODE_MAX
+};
+
+const char* mode_str[ MODE_MAX ] = { "tree", "optimized", "compiled" };
+
+// Build expression str for action in the given mode. Returns nullptr if the expression does not
+// parse.
+expr_t* build( action_t* action, const std::string& str, bench_mode_e mode )
+{
+  sim_t* sim = action -> sim;
+
+  expr_t* e = expr_t::parse( action, str, mode != MODE_TREE );
+  if ( ! e )
+    return nullptr;
+
+  if ( mode != MODE_TREE )
+    e = e -> optimize();
+
+  if ( mode == MODE_COMPILED )
+  {
+    int compile_expressions = sim -> compile_expressions;
+    sim -> compile_expressions = 1;
+    e = expr_t::compile( action, e );
+    sim -> compile_expressions = compile_expressions;
+  }
+
+  return e;
+}
+
+// Evaluate the expressions round-robin for (at least) n evaluations, and return evaluations per
+// second
+double measure( const std::vector<expr_t*>& exprs, uint64_t n, double& sink )
+{
+  if ( exprs.empty() )
+    return 0;
+
+  uint64_t rounds = std::max( uint64_t( 1 ), n / exprs.size() );
+  double sum = 0;
+
+  stopwatch_t sw( STOPWATCH_WALL );
+  for ( uint64_t round = 0; round < rounds; ++round )
+  {
+    for ( size_t i = 0, end = exprs.size(); i < end; ++i )
+    {
+      sum += exprs[ i ] -> eval();
+    }
+  }
+  double elapsed = sw.elapsed();
+
+  sink += sum;
+
+  return elapsed > 0 ? rounds * exprs.size() / elapsed : 0;
+}
+
+void print_row( const std::string& name, size_t n_exprs, const double* evals_per_sec )
+{
+  util::printf( "%-24s %7u", name.c_str(), as<unsigned>( n_exprs ) );
+  for ( int mode = 0; mode < MODE_MAX; ++mode )
+  {
+    util::printf( " %14.0f", evals_per_sec[ mode ] );
+  }
+  util::printf( " %8.2fx\n", evals_per_sec[ MODE_TREE ] > 0
+                             ? evals_per_sec[ MODE_COMPILED ] / evals_per_sec[ MODE_TREE ] : 0.0 );
+}
+
+void print_header( const char* title )
+{
+  util::printf( "\n%-24s %7s", title, "exprs" );
+  for ( int mode = 0; mode < MODE_MAX; ++mode )
+  {
+    util::printf( " %14s", mode_str[ mode ] );
+  }
+  util::printf( " %9s\n", "speedup" );
+}
+
+// Node type benchmarks against the synthetic actor
+void bench_node_types( player_t* actor, uint64_t n, double& sink )
+{
+  action_t* action = actor -> find_action( "bloodthirst" );
+  if ( ! action && ! actor -> action_list.empty() )
+    action = actor -> action_list.front();
+
+  if ( ! action )
+  {
+    util::fprintf( stderr, "No action to build expressions for on actor %s\n", actor -> name() );
+    return;
+  }
+
+  print_header( "node type (evals/sec)" );
+
+  for ( const auto& entry : node_type_exprs )
+  {
+    double evals_per_sec[ MODE_MAX ] = { 0, 0, 0 };
+    for ( int mode = 0; mode < MODE_MAX; ++mode )
+    {
+      std::vector<expr_t*> exprs;
+      if ( expr_t* e = build( action, entry.expression, static_cast<bench_mode_e>( mode ) ) )
+        exprs.push_back( e );
+
+      evals_per_sec[ mode ] = measure( exprs, n, sink );
+      range::dispose( exprs );
+    }
+
+    print_row( entry.type, 1, evals_per_sec );
+  }
+}
+
+// Replay the action list conditions of the actors as a corpus
+void bench_corpus( const std::vector<player_t*>& actors, uint64_t n, double& sink )
+{
+  if ( actors.empty() )
+    return;
+
+  print_header( "corpus (evals/sec)" );
+
+  double total[ MODE_MAX ] = { 0, 0, 0 };
+  size_t total_exprs = 0;
+
+  for ( player_t* actor : actors )
+  {
+    double evals_per_sec[ MODE_MAX ] = { 0, 0, 0 };
+    size_t n_exprs = 0;
+
+    for ( int mode = 0; mode < MODE_MAX; ++mode )
+    {
+      std::vector<expr_t*> exprs;
+      for ( action_t* action : actor -> action_list )
+      {
+        if ( action -> option.if_expr_str.empty() )
+          continue;
+
+        if ( expr_t* e = build( action, action -> option.if_expr_str, static_cast<bench_mode_e>( mode ) ) )
+          exprs.push_back( e );
+      }
+
+      n_exprs = exprs.size();
+      evals_per_sec[ mode ] = measure( exprs, n, sink );
+      // Weigh the corpus total by time spent per evaluation
+      if ( evals_per_sec[ mode ] > 0 )
+        total[ mode ] += n_exprs / evals_per_sec[ mode ];
+      range::dispose( exprs );
+    }
+
+    total_exprs += n_exprs;
+    print_row( actor -> name_str, n_exprs, evals_per_sec );
+  }
+
+  for ( int mode = 0; mode < MODE_MAX; ++mode )
+  {
+    total[ mode ] = total[ mode ] > 0 ? total_exprs / total[ mode ] : 0;
+  }
+
+  print_row( "total", total_exprs, total );
+}
+
+// RAII-wrapper for the global initialization the simulator needs
+struct bench_initializer_t
+{
+  bench_initializer_t()
+  {
+    dbc::init();
+    module_t::init();
+    unique_gear::register_hotfixes();
+    unique_gear::register_special_effects();
+    unique_gear::sort_special_effects();
+  }
+
+  ~bench_initializer_t()
+  {
+    unique_gear::unregister_special_effects();
+    dbc::de_init();
+  }
+};
+
+} // anonymous namespace ====================================================
+
+int main( int argc, char** argv )
+{
+  std::locale::global( std::locale( "C" ) );
+
+  bench_initializer_t init;
+
+  uint64_t n_evaluations = 1000000;
+  std::vector<std::string> args( synthetic_actor, synthetic_actor + sizeof_array( synthetic_actor ) );
+  std::vector<std::string> cmd_args = io::utf8_args( argc, argv );
+
+  for ( size_t i = 0; i < cmd_args.size(); ++i )
+  {
+    if ( util::str_prefix_ci( cmd_args[ i ], "bench_evaluations=" ) )
+      n_evaluations = util::to_unsigned( cmd_args[ i ].substr( 18 ) );
+    else
+      args.push_back( cmd_args[ i ] );
+  }
+
+  sim_t sim;
+  sim_control_t control;
+
+  try
+  {
+    control.options.parse_args( args );
+    hotfix::apply();
+    sim.setup( &control );
+  }
+  catch ( const std::exception& e )
+  {
+    std::cerr << "ERROR! Setup failure: " << e.what() << std::endl;
+    return 1;
+  }
+
+  if ( sim.canceled || ! sim.init() )
+  {
+    std::cerr << "ERROR! Simulator initialization failed" << std::endl;
+    return 1;
+  }
+
+  // Put the actors in their initial combat state, as the first iteration would
+  sim.current_iteration = 0;
+  sim.activate_actors();
+  sim.reset();
+
+  double sink = 0;
+  player_t* synthetic = sim.find_player( "Bench_Warrior" );
+  if ( synthetic )
+    bench_node_types( synthetic, n_evaluations, sink );
+
+  std::vector<player_t*> corpus;
+  for ( player_t* p : sim.player_no_pet_list )
+  {
+    if ( p != synthetic )
+      corpus.push_back( p );
+  }
+  bench_corpus( corpus, n_evaluations, sink );
+
+  // Keep the evaluations from being optimized away
+  util::printf( "\nchecksum: %g\n", sink );
+
+  return 0;
+}
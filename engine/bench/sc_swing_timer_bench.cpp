@@ -0,0 +1,235 @@
+// ==========================================================================
+// Dedmonwakeen's Raid DPS/TPS Simulator.
+// Send questions to natehieter@gmail.com
+// ==========================================================================
+
+// Swing timer rescheduling microbenchmark
+//
+// Measures the cost of haste changes on a dual-wielding actor. The first part moves events earlier
+// in a populated timing wheel, comparing the in-place event_t::adjust() against canceling the
+// event and creating a new one. The second part sets up a synthetic dual-wield fury warrior with
+// both auto attacks swinging and its cooldowns running, and alternates haste procs (a haste rating
+// proc and Bloodlust) on it, each of which reschedules the swings and hasted cooldowns.
+//
+// Usage: simc_bench_swing_timer [bench_iterations=N] [option=value ...]
+//
+// Options prefixed with bench_ are consumed by the benchmark, everything else is passed on to the
+// simulator as is.
+
+#include "simulationcraft.hpp"
+
+namespace { // anonymous namespace ==========================================
+
+// Synthetic dual-wield actor
+const char* synthetic_actor[] = {
+  "warrior=Bench_Fury",
+  "spec=fury",
+  "level=110",
+  "race=orc",
+  "main_hand=bench_mh,weapon=axe2h_3.60speed_9000min_11000max",
+  "off_hand=bench_oh,weapon=axe2h_3.60speed_9000min_11000max",
+  "actions=auto_attack",
+  "actions+=/bloodthirst",
+  "actions+=/raging_blow",
+  "actions+=/whirlwind",
+};
+
+// Number of unrelated events kept in the timing wheel while moving events
+const unsigned BACKGROUND_EVENTS = 256;
+
+struct bench_event_t : public event_t
+{
+  bench_event_t( sim_t& sim, timespan_t delta_time ) : event_t( sim, delta_time )
+  { }
+
+  const char* name() const override
+  { return "Bench-Event"; }
+
+  void execute() override
+  { }
+};
+
+// Deterministic pseudo-random delays, 1ms - ~4s
+struct delay_generator_t
+{
+  uint32_t state = 1;
+
+  timespan_t next()
+  {
+    state = state * 1664525u + 1013904223u;
+    return timespan_t::from_millis( 1 + ( state >> 20 ) );
+  }
+};
+
+enum bench_mode_e
+{
+  MODE_RECREATE = 0,
+  MODE_ADJUST,
+  MODE_MAX
+};
+
+const char* mode_str[ MODE_MAX ] = { "cancel+recreate", "adjust" };
+
+// Move a set of swing-like events earlier n times, and return moves per second. Canceled events
+// are left in the timing wheel, as in the simulator; their count is returned in leftover.
+double bench_event_moves( sim_t& sim, bench_mode_e mode, uint64_t n, uint64_t& leftover )
+{
+  event_manager_t& em = sim.event_mgr;
+  delay_generator_t delays;
+
+  for ( unsigned i = 0; i < BACKGROUND_EVENTS; ++i )
+    make_event<bench_event_t>( sim, sim, delays.next() );
+
+  std::vector<event_t*> swings;
+  for ( unsigned i = 0; i < 2; ++i )
+    swings.push_back( make_event<bench_event_t>( sim, sim, timespan_t::from_seconds( 3.6 ) ) );
+
+  uint64_t events_before = em.events_remaining;
+
+  stopwatch_t sw( STOPWATCH_WALL );
+  for ( uint64_t i = 0; i < n; ++i )
+  {
+    event_t*& swing = swings[ i & 1 ];
+    timespan_t new_remains = delays.next();
+
+    if ( mode == MODE_ADJUST )
+    {
+      swing -> adjust( new_remains );
+    }
+    else
+    {
+      event_t::cancel( swing );
+      swing = make_event<bench_event_t>( sim, sim, new_remains );
+    }
+  }
+  double elapsed = sw.elapsed();
+
+  leftover = em.events_remaining - events_before;
+
+  em.flush();
+  em.reset();
+
+  return elapsed > 0 ? n / elapsed : 0;
+}
+
+// Alternately trigger and expire haste procs on the actor n times, and return haste changes per
+// second. The procs are triggered without a duration, so the only events they move are the swings
+// and cooldown recharges of the actor.
+double bench_haste_procs( const std::vector<buff_t*>& procs, uint64_t n )
+{
+  stopwatch_t sw( STOPWATCH_WALL );
+  for ( uint64_t i = 0; i < n; ++i )
+  {
+    buff_t* proc = procs[ i % procs.size() ];
+    if ( proc -> check() )
+      proc -> expire();
+    else
+      proc -> trigger( 1, buff_t::DEFAULT_VALUE(), -1.0, timespan_t::zero() );
+  }
+  double elapsed = sw.elapsed();
+
+  return elapsed > 0 ? n / elapsed : 0;
+}
+
+// RAII-wrapper for the global initialization the simulator needs
+struct bench_initializer_t
+{
+  bench_initializer_t()
+  {
+    dbc::init();
+    module_t::init();
+    unique_gear::register_hotfixes();
+    unique_gear::register_special_effects();
+    unique_gear::sort_special_effects();
+  }
+
+  ~bench_initializer_t()
+  {
+    unique_gear::unregister_special_effects();
+    dbc::de_init();
+  }
+};
+
+} // anonymous namespace ====================================================
+
+int main( int argc, char** argv )
+{
+  std::locale::global( std::locale( "C" ) );
+
+  bench_initializer_t init;
+
+  uint64_t n_iterations = 1000000;
+  std::vector<std::string> args( synthetic_actor, synthetic_actor + sizeof_array( synthetic_actor ) );
+  std::vector<std::string> cmd_args = io::utf8_args( argc, argv );
+
+  for ( size_t i = 0; i < cmd_args.size(); ++i )
+  {
+    if ( util::str_prefix_ci( cmd_args[ i ], "bench_iterations=" ) )
+      n_iterations = util::to_unsigned( cmd_args[ i ].substr( 17 ) );
+    else
+      args.push_back( cmd_args[ i ] );
+  }
+
+  sim_t sim;
+  sim_control_t control;
+
+  try
+  {
+    control.options.parse_args( args );
+    hotfix::apply();
+    sim.setup( &control );
+  }
+  catch ( const std::exception& e )
+  {
+    std::cerr << "ERROR! Setup failure: " << e.what() << std::endl;
+    return 1;
+  }
+
+  if ( sim.canceled || ! sim.init() )
+  {
+    std::cerr << "ERROR! Simulator initialization failed" << std::endl;
+    return 1;
+  }
+
+  // Event moves in a populated timing wheel
+  util::printf( "\n%-24s %14s %10s\n", "event moves", "moves/sec", "leftover" );
+  for ( int mode = 0; mode < MODE_MAX; ++mode )
+  {
+    uint64_t leftover = 0;
+    double moves_per_sec = bench_event_moves( sim, static_cast<bench_mode_e>( mode ), n_iterations, leftover );
+    util::printf( "%-24s %14.0f %10u\n", mode_str[ mode ], moves_per_sec, as<unsigned>( leftover ) );
+  }
+
+  player_t* actor = sim.find_player( "Bench_Fury" );
+  if ( ! actor || ! actor -> main_hand_attack || ! actor -> off_hand_attack )
+  {
+    std::cerr << "ERROR! No dual-wielding actor to benchmark haste procs on" << std::endl;
+    return 1;
+  }
+
+  // Put the actor in combat, with both auto attacks swinging and its cooldowns running
+  sim.current_iteration = 0;
+  sim.activate_actors();
+  sim.reset();
+
+  actor -> main_hand_attack -> schedule_execute();
+  actor -> off_hand_attack -> schedule_execute();
+  for ( action_t* action : actor -> action_list )
+  {
+    if ( action -> cooldown -> duration > timespan_t::zero() )
+      action -> cooldown -> start( action );
+  }
+
+  std::vector<buff_t*> procs;
+  procs.push_back( stat_buff_creator_t( actor, "bench_haste_proc" ).add_stat( STAT_HASTE_RATING, 2000 ) );
+  procs.push_back( actor -> buffs.bloodlust );
+
+  uint64_t events_before = sim.event_mgr.events_remaining;
+  double changes_per_sec = bench_haste_procs( procs, n_iterations );
+
+  util::printf( "\n%-24s %14s %10s\n", "dual-wield haste procs", "changes/sec", "leftover" );
+  util::printf( "%-24s %14.0f %10u\n", actor -> name(), changes_per_sec,
+                as<unsigned>( sim.event_mgr.events_remaining - events_before ) );
+
+  return 0;
+}
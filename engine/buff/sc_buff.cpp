@@ -187,6 +187,9 @@ buff_t::buff_t( const buff_creation::buff_creator_basics_t& params ) :
   requires_invalidation(),
   current_value(),
   current_stack(),
+  version( 0 ),
+  touched( false ),
+  lazy_expiration( timespan_t::min() ),
   buff_duration( params._duration ),
   default_chance( 1.0 ),
   current_tick( 0 ),
@@ -651,6 +654,9 @@ void buff_t::datacollection_begin()
 
 void buff_t::datacollection_end()
 {
+  // Account for a lazy expiration that has not been read since
+  check();
+
   timespan_t time = player ? player -> iteration_fight_length : sim -> current_time();
 
   uptime_pct.add( time != timespan_t::zero() ? 100.0 * iteration_uptime_sum / time : 0 );
@@ -736,7 +742,7 @@ timespan_t buff_t::tick_time() const
 
 int buff_t::stack()
 {
-  int cs = current_stack;
+  int cs = check();
   if ( last_benefite_update != sim -> current_time() )
   {
     // make sure we only record a benfit once per sim event
@@ -753,7 +759,7 @@ int buff_t::stack()
 
 int buff_t::total_stack()
 {
-  int s = current_stack;
+  int s = check();
 
   if ( delay )
     s += debug_cast< buff_delay_t* >( delay ) -> stacks;
@@ -765,7 +771,7 @@ int buff_t::total_stack()
 
 bool buff_t::may_react( int stack )
 {
-  if ( current_stack == 0    ) return false;
+  if ( check() == 0          ) return false;
   if ( stack > current_stack ) return false;
   if ( stack < 1             ) return false;
   if ( ! reactable           ) return false;
@@ -785,7 +791,7 @@ int buff_t::stack_react()
 {
   int stack = 0;
 
-  for ( int i = 1; i <= current_stack; i++ )
+  for ( int i = 1, end = check(); i <= end; i++ )
   {
     if ( stack_react_time[ i ] > sim -> current_time() ) break;
     stack++;
@@ -798,10 +804,14 @@ int buff_t::stack_react()
 
 timespan_t buff_t::remains() const
 {
-  if ( current_stack <= 0 )
+  if ( check() <= 0 )
   {
     return timespan_t::zero();
   }
+  if ( lazy_expiration != timespan_t::min() )
+  {
+    return lazy_expiration - sim -> current_time();
+  }
   if ( ! expiration.empty() )
   {
     return expiration.back() -> occurs() - sim -> current_time();
@@ -833,6 +843,45 @@ bool buff_t::remains_lt( timespan_t time ) const
   return ( time_remaining < time );
 }
 
+// buff_t::lazy_expiration_eligible =========================================
+
+// Lazy expiration applies to passive buffs only: plain buff_t objects with no ticks, callbacks,
+// cache invalidations or regeneration changes that would need to happen at the expiration time.
+bool buff_t::lazy_expiration_eligible() const
+{
+  if ( ! sim -> lazy_buff_expiration )
+    return false;
+
+  if ( typeid( *this ) != typeid( buff_t ) )
+    return false;
+
+  if ( player && player -> ready_type == READY_TRIGGER )
+    return false;
+
+  return stack_behavior != BUFF_STACK_ASYNCHRONOUS && tick_behavior == BUFF_TICK_NONE &&
+         ! tick_callback && ! stack_change_callback && ! requires_invalidation &&
+         invalidate_list.empty() && ! change_regen_rate;
+}
+
+// buff_t::bump_version =====================================================
+
+void buff_t::bump_version()
+{
+  version++;
+  if ( player )
+    player -> snapshot_version++;
+}
+
+// buff_t::resolve_lazy_expiration ==========================================
+
+void buff_t::resolve_lazy_expiration() const
+{
+  if ( lazy_expiration <= sim -> current_time() )
+  {
+    const_cast<buff_t*>( this ) -> expire();
+  }
+}
+
 // buff_t::trigger ==========================================================
 
 bool buff_t::trigger( action_t*  a,
@@ -894,6 +943,8 @@ bool buff_t::trigger( int        stacks,
   if ( ( ! activated || stack_behavior == BUFF_STACK_ASYNCHRONOUS ) && player
     && player -> in_combat && sim -> default_aura_delay > timespan_t::zero() )
   {
+    touch();
+
     // In-game, procs that happen "close to eachother" are usually delayed into the
     // same time slot. We roughly model this by allowing procs that happen during the
     // buff's already existing delay period to trigger at the same time as the first
@@ -920,6 +971,8 @@ void buff_t::execute( int stacks, double value, timespan_t duration )
   if ( value == DEFAULT_VALUE() && default_value != DEFAULT_VALUE() )
     value = default_value;
 
+  touch();
+
   if ( last_trigger > timespan_t::zero() )
   {
     trigger_intervals.add( ( sim -> current_time() - last_trigger ).total_seconds() );
@@ -933,7 +986,7 @@ void buff_t::execute( int stacks, double value, timespan_t duration )
     increment( stacks == 1 ? ( reverse ? _max_stack : stacks ) : stacks, value, duration );
   else
   {
-    if ( reverse && current_stack > 0 )
+    if ( reverse && check() > 0 )
       decrement( stacks, value );
     else
       increment( stacks == 1 ? ( reverse ? _max_stack : stacks ) : stacks, value, duration );
@@ -962,7 +1015,7 @@ void buff_t::increment( int        stacks,
 
   if ( _max_stack == 0 ) return;
 
-  if ( current_stack == 0 || stack_behavior == BUFF_STACK_ASYNCHRONOUS )
+  if ( check() == 0 || stack_behavior == BUFF_STACK_ASYNCHRONOUS )
   {
     start( stacks, value, duration );
   }
@@ -979,7 +1032,7 @@ void buff_t::decrement( int    stacks,
 {
   if ( overridden ) return;
 
-  if ( _max_stack == 0 || current_stack <= 0 ) return;
+  if ( _max_stack == 0 || check() <= 0 ) return;
 
   if ( stacks == 0 || current_stack <= stacks )
   {
@@ -995,6 +1048,7 @@ void buff_t::decrement( int    stacks,
       stack_uptime[ current_stack ].update( false, sim -> current_time() );
 
     current_stack -= stacks;
+    bump_version();
 
     if ( value == DEFAULT_VALUE() && default_value != DEFAULT_VALUE() )
       value = default_value;
@@ -1025,30 +1079,38 @@ void buff_t::extend_duration( player_t* p, timespan_t extra_seconds )
     return;
   }
 
+  bump_version();
+
   if ( stack_behavior == BUFF_STACK_ASYNCHRONOUS )
   {
     sim -> errorf( "%s attempts to extend asynchronous buff %s.", p -> name(), name() );
     sim -> cancel();
   }
 
-  assert( expiration.size() == 1 );
+  bool lazy = lazy_expiration != timespan_t::min();
+  assert( lazy || expiration.size() == 1 );
 
   if ( extra_seconds > timespan_t::zero() )
   {
-    expiration.front() -> reschedule( expiration.front() -> remains() + extra_seconds );
+    if ( lazy )
+      lazy_expiration += extra_seconds;
+    else
+      expiration.front() -> reschedule( expiration.front() -> remains() + extra_seconds );
+
+    timespan_t expiration_time = sim -> current_time() + remains();
 
     if (sim->log)
       sim->out_log.printf("%s extends buff %s by %.1f seconds. New expiration time: %.1f",
                           p->name(), name_str.c_str(), extra_seconds.total_seconds(), 
-                          expiration.front()->occurs().total_seconds());
+                          expiration_time.total_seconds());
 
     if ( sim -> debug )
       sim -> out_debug.printf( "%s extends buff %s by %.1f seconds. New expiration time: %.1f",
-                     p -> name(), name_str.c_str(), extra_seconds.total_seconds(), expiration.front() -> occurs().total_seconds() );
+                     p -> name(), name_str.c_str(), extra_seconds.total_seconds(), expiration_time.total_seconds() );
   }
   else if ( extra_seconds < timespan_t::zero() )
   {
-    timespan_t reschedule_time = expiration.front() -> remains() + extra_seconds;
+    timespan_t reschedule_time = remains() + extra_seconds;
 
     if ( reschedule_time <= timespan_t::zero() )
     {
@@ -1062,14 +1124,21 @@ void buff_t::extend_duration( player_t* p, timespan_t extra_seconds )
       reschedule_time = rng().gauss( lag, dev );
     }
 
-    event_t::cancel( expiration.front() );
-    expiration.erase( expiration.begin() );
+    if ( lazy )
+    {
+      lazy_expiration = sim -> current_time() + reschedule_time;
+    }
+    else
+    {
+      event_t::cancel( expiration.front() );
+      expiration.erase( expiration.begin() );
 
-    expiration.push_back( make_event<expiration_t>( *sim, this, reschedule_time ) );
+      expiration.push_back( make_event<expiration_t>( *sim, this, reschedule_time ) );
+    }
 
     if ( sim -> debug )
       sim -> out_debug.printf( "%s decreases buff %s by %.1f seconds. New expiration time: %.1f",
-                     p -> name(), name_str.c_str(), -extra_seconds.total_seconds(), expiration.back() -> occurs().total_seconds() );
+                     p -> name(), name_str.c_str(), -extra_seconds.total_seconds(), ( sim -> current_time() + reschedule_time ).total_seconds() );
   }
 }
 
@@ -1081,6 +1150,9 @@ void buff_t::start( int        stacks,
 {
   if ( _max_stack == 0 ) return;
 
+  touch();
+  bump_version();
+
 #ifndef NDEBUG
   if ( stack_behavior != BUFF_STACK_ASYNCHRONOUS && current_stack != 0 )
   {
@@ -1135,7 +1207,11 @@ void buff_t::start( int        stacks,
     last_start = sim -> current_time();
   }
 
-  if ( d > timespan_t::zero() )
+  if ( d > timespan_t::zero() && lazy_expiration_eligible() )
+  {
+    lazy_expiration = sim -> current_time() + d;
+  }
+  else if ( d > timespan_t::zero() )
   {
     expiration.push_back( make_event<expiration_t>( *sim, this, stacks, d ) );
     /* TOCHECK: This seems wrong, since bump() already removes expiration events when we are at max stacks
@@ -1198,14 +1274,19 @@ void buff_t::refresh( int        stacks,
       event_t::cancel( expiration.front() );
       expiration.erase( expiration.begin() );
     }
+    lazy_expiration = timespan_t::min();
     // Infinite ticking buff refreshes shouldnt happen, but cancel ongoing
     // tick event just to be sure.
     event_t::cancel( tick_event );
   }
   else
   {
+    // Lazily expiring application, or infinite duration -> lazy duration of d
+    if ( lazy_expiration != timespan_t::min() ||
+         ( expiration.empty() && lazy_expiration_eligible() ) )
+      lazy_expiration = sim -> current_time() + d;
     // Infinite duration -> duration of d
-    if ( expiration.empty() )
+    else if ( expiration.empty() )
       expiration.push_back( make_event<expiration_t>( *sim, this, d ) );
     else
     {
@@ -1244,6 +1325,12 @@ void buff_t::bump( int stacks, double value )
 {
   if ( _max_stack == 0 ) return;
 
+  // Apply a passed lazy expiration before stacking on top of the buff
+  check();
+
+  touch();
+  bump_version();
+
   current_value = value;
 
   if ( requires_invalidation ) invalidate_cache();
@@ -1391,8 +1478,18 @@ void buff_t::expire( timespan_t delay )
     event_t::cancel( expiration_delay );
   }
 
+  // A lazily expiring buff is accounted as expired at its end time, if it has passed
+  timespan_t expiration_time = sim -> current_time();
   timespan_t remaining_duration = timespan_t::zero();
   int expiration_stacks = current_stack;
+  if ( lazy_expiration != timespan_t::min() )
+  {
+    if ( lazy_expiration > expiration_time )
+      remaining_duration = lazy_expiration - expiration_time;
+    else
+      expiration_time = lazy_expiration;
+    lazy_expiration = timespan_t::min();
+  }
   if ( ! expiration.empty() )
   {
     remaining_duration = expiration.back() -> remains();
@@ -1406,7 +1503,7 @@ void buff_t::expire( timespan_t delay )
   event_t::cancel( tick_event );
 
   assert( as<std::size_t>( current_stack ) < stack_uptime.size() );
-  stack_uptime[ current_stack ].update( false, sim -> current_time() );
+  stack_uptime[ current_stack ].update( false, expiration_time );
 
   if ( player && change_regen_rate )
     player -> do_dynamic_regen();
@@ -1432,16 +1529,17 @@ void buff_t::expire( timespan_t delay )
   int old_stack = current_stack;
 
   current_stack = 0;
+  bump_version();
   if ( requires_invalidation ) invalidate_cache();
   if ( last_start >= timespan_t::zero() )
   {
-    iteration_uptime_sum += sim -> current_time() - last_start;
+    iteration_uptime_sum += expiration_time - last_start;
     if ( ! constant && ! overridden && sim -> buff_uptime_timeline )
     {
       timespan_t start_time = timespan_t::from_seconds( last_start.total_millis() / 1000 ) ;
-      timespan_t end_time = timespan_t::from_seconds( sim -> current_time().total_millis() / 1000 );
+      timespan_t end_time = timespan_t::from_seconds( expiration_time.total_millis() / 1000 );
       timespan_t begin_uptime = (( timespan_t::from_seconds( 1 ) - last_start ) % timespan_t::from_seconds( 1 ) );
-      timespan_t end_uptime = (sim -> current_time() % timespan_t::from_seconds( 1 ));
+      timespan_t end_uptime = (expiration_time % timespan_t::from_seconds( 1 ));
 
       if ( last_start % timespan_t::from_seconds( 1 ) == timespan_t::zero() )
         begin_uptime = timespan_t::from_seconds( 1 );
@@ -1537,6 +1635,7 @@ void buff_t::aura_loss()
 
 void buff_t::reset()
 {
+  bump_version();
   event_t::cancel( delay );
   event_t::cancel( expiration_delay );
   event_t::cancel( tick_event );
@@ -1546,6 +1645,15 @@ void buff_t::reset()
   last_trigger = timespan_t::min();
 }
 
+// buff_t::is_reset =========================================================
+
+bool buff_t::is_reset() const
+{
+  return current_stack <= 0 && ! delay && ! expiration_delay && ! tick_event &&
+         expiration.empty() && lazy_expiration == timespan_t::min() && last_start == timespan_t::min() &&
+         last_trigger == timespan_t::min();
+}
+
 // buff_t::merge ============================================================
 
 void buff_t::merge( const buff_t& other )
@@ -1662,14 +1770,14 @@ static buff_t* find_potion_buff( const std::vector<buff_t*>& buffs, player_t* so
   return nullptr;
 }
 
-buff_t* buff_t::find_expressable( const std::vector<buff_t*>& buffs,
+buff_t* buff_t::find_expressable( player_t* p,
                                   const std::string& name,
                                   player_t* source )
 {
   if ( util::str_compare_ci( "potion", name ) )
-    return find_potion_buff( buffs, source );
+    return find_potion_buff( p -> buff_list, source );
   else
-    return find( buffs, name, source );
+    return find( p, name, source );
 }
 
 // buff_t::to_str ===========================================================
@@ -1732,8 +1840,36 @@ expr_t* buff_t::create_expression(  std::string buff_name,
       }
       return buff;
     }
+
+    // Target-specific buffs change with the action target, so only static buffs have a fixed set of
+    // dependencies. By default, the expression depends on the stack state of the buff.
+    bool dependencies( expr_deps_t& deps ) const override
+    {
+      if ( ! static_buff ) return false;
+      deps.versions.push_back( &static_buff -> version );
+      return true;
+    }
   };
 
+  // The common state of static buffs is read through state expressions
+  if ( static_buff )
+  {
+    expr_t* e = nullptr;
+    if ( type == "up" )
+      e = make_state_expr<expr_ref_t::REF_BUFF_UP>( "buff_up", *static_buff );
+    else if ( type == "down" )
+      e = make_state_expr<expr_ref_t::REF_BUFF_DOWN>( "buff_down", *static_buff );
+    else if ( type == "stack" )
+      e = make_state_expr<expr_ref_t::REF_BUFF_STACK>( "buff_stack", *static_buff );
+    else if ( type == "remains" )
+      e = make_state_expr<expr_ref_t::REF_BUFF_REMAINS>( "buff_remains", *static_buff );
+
+    if ( e )
+      // Lazily expiring buffs change state with time, without a version change
+      return make_dependent_expr( *static_buff -> sim, e, { &static_buff -> version },
+                                  type == "remains" || static_buff -> sim -> lazy_buff_expiration );
+  }
+
   if ( type == "duration" )
   {
     struct duration_expr_t : public buff_expr_t
@@ -1741,6 +1877,7 @@ expr_t* buff_t::create_expression(  std::string buff_name,
       duration_expr_t( std::string bn, action_t* a, buff_t* b ) :
         buff_expr_t( "buff_duration", bn, a, b ) {}
       virtual double evaluate() override { return buff() -> buff_duration.total_seconds(); }
+      bool dependencies( expr_deps_t& ) const override { return false; }
     };
     return new duration_expr_t( buff_name, action, static_buff );
   }
@@ -1751,6 +1888,8 @@ expr_t* buff_t::create_expression(  std::string buff_name,
       remains_expr_t( std::string bn, action_t* a, buff_t* b ) :
         buff_expr_t( "buff_remains", bn, a, b ) {}
       virtual double evaluate() override { return buff() -> remains().total_seconds(); }
+      bool dependencies( expr_deps_t& deps ) const override
+      { deps.time = true; return buff_expr_t::dependencies( deps ); }
     };
     return new remains_expr_t( buff_name, action, static_buff );
   }
@@ -1761,6 +1900,13 @@ expr_t* buff_t::create_expression(  std::string buff_name,
       cooldown_remains_expr_t( std::string bn, action_t* a, buff_t* b ) :
         buff_expr_t( "buff_cooldown_remains", bn, a, b ) {}
       virtual double evaluate() override { return buff() -> cooldown -> remains().total_seconds(); }
+      bool dependencies( expr_deps_t& deps ) const override
+      {
+        if ( ! static_buff ) return false;
+        deps.versions.push_back( &static_buff -> cooldown -> version );
+        deps.time = true;
+        return true;
+      }
     };
     return new cooldown_remains_expr_t( buff_name, action, static_buff );
   }
@@ -1821,6 +1967,7 @@ expr_t* buff_t::create_expression(  std::string buff_name,
       value_expr_t( std::string bn, action_t* a, buff_t* b ) :
         buff_expr_t( "buff_value", bn, a, b ) {}
       virtual double evaluate() override { return buff() -> value(); }
+      bool dependencies( expr_deps_t& ) const override { return false; }
     };
     return new value_expr_t( buff_name, action, static_buff );
   }
@@ -1837,6 +1984,8 @@ expr_t* buff_t::create_expression(  std::string buff_name,
       { auto b = buff_expr_t::create(); b -> reactable = true; return b; }
       double evaluate() override
       { return buff() -> stack_react(); }
+      bool dependencies( expr_deps_t& deps ) const override
+      { deps.time = true; return buff_expr_t::dependencies( deps ); }
     };
     return new react_expr_t( buff_name, action, static_buff );
   }
@@ -1853,6 +2002,8 @@ expr_t* buff_t::create_expression(  std::string buff_name,
       { auto b = buff_expr_t::create(); b -> reactable = true; return b; }
       double evaluate() override
       { return 100.0 * buff() -> stack_react() / buff() -> max_stack(); }
+      bool dependencies( expr_deps_t& deps ) const override
+      { deps.time = true; return buff_expr_t::dependencies( deps ); }
     };
     return new react_pct_expr_t( buff_name, action, static_buff );
   }
@@ -1869,6 +2020,13 @@ expr_t* buff_t::create_expression(  std::string buff_name,
         else
           return buff() -> cooldown -> remains().total_seconds();
       }
+      bool dependencies( expr_deps_t& deps ) const override
+      {
+        if ( ! static_buff ) return false;
+        deps.versions.push_back( &static_buff -> cooldown -> version );
+        deps.time = true;
+        return buff_expr_t::dependencies( deps );
+      }
     };
     return new cooldown_react_expr_t( buff_name, action, static_buff );
   }
@@ -2028,6 +2186,7 @@ void stat_buff_t::decrement( int stacks, double /* value */ )
       stats[ i ].current_value -= delta;
     }
     current_stack -= stacks;
+    bump_version();
 
     invalidate_cache();
 
@@ -2120,6 +2279,7 @@ void cost_reduction_buff_t::decrement( int stacks, double /* value */ )
     double delta = amount * stacks;
     player -> cost_reduction_loss( school, delta );
     current_stack -= stacks;
+    bump_version();
     current_value -= delta;
   }
 }
@@ -937,7 +937,7 @@ public:
   role_e    primary_role() const override;
   stat_e    primary_stat() const override;
   stat_e    convert_hybrid_stat( stat_e s ) const override;
-  void      invalidate_cache( cache_e ) override;
+  void      init_cache_dependencies() override;
   double    resource_loss( resource_e resource_type, double amount, gain_t* g = nullptr, action_t* a = nullptr ) override;
   void      merge( player_t& other ) override;
   void      analyze( sim_t& sim ) override;
@@ -1759,7 +1759,7 @@ struct base_ghoul_pet_t : public death_knight_pet_t
 
   timespan_t available() const override
   {
-    double energy = resources.current[ RESOURCE_ENERGY ];
+    double energy = resource_current( RESOURCE_ENERGY );
 
     // Cheapest Ability need 40 Energy
     if ( energy > 40 )
@@ -8651,25 +8651,18 @@ void death_knight_t::combat_begin()
   }
 }
 
-// death_knight_t::invalidate_cache =========================================
+// death_knight_t::init_cache_dependencies ==================================
 
-void death_knight_t::invalidate_cache( cache_e c )
+void death_knight_t::init_cache_dependencies()
 {
-  player_t::invalidate_cache( c );
+  player_t::init_cache_dependencies();
 
-  switch ( c )
-  {
-    case CACHE_CRIT_CHANCE:
-      if ( spec.riposte -> ok() )
-        player_t::invalidate_cache( CACHE_PARRY );
-      break;
-    case CACHE_MASTERY:
-      player_t::invalidate_cache( CACHE_PLAYER_DAMAGE_MULTIPLIER );
-      if ( specialization() == DEATH_KNIGHT_BLOOD )
-        player_t::invalidate_cache( CACHE_ATTACK_POWER );
-      break;
-    default: break;
-  }
+  if ( spec.riposte -> ok() )
+    cache.add_dependency( CACHE_CRIT_CHANCE, CACHE_PARRY );
+
+  cache.add_dependency( CACHE_MASTERY, CACHE_PLAYER_DAMAGE_MULTIPLIER );
+  if ( specialization() == DEATH_KNIGHT_BLOOD )
+    cache.add_dependency( CACHE_MASTERY, CACHE_ATTACK_POWER );
 }
 
 // death_knight_t::primary_role =============================================
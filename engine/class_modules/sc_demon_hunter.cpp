@@ -563,6 +563,7 @@ public:
   void init_rng() override;
   void init_scaling() override;
   void init_spells() override;
+  void init_cache_dependencies() override;
   void invalidate_cache( cache_e ) override;
   resource_e primary_resource() const override;
   role_e primary_role() const override;
@@ -3620,6 +3621,8 @@ struct chaos_strike_base_t : public demon_hunter_attack_t
   {
     energize_amount = p->spec.chaos_strike_refund->effectN(1).resource(RESOURCE_FURY);
     aoe = s->effectN(1).chain_target();
+    // The crit roll in snapshot_state() depends on the chain target
+    batch_snapshot = false;
 
     // Don't put damage modifiers here, they should go in chaos_strike_damage_t.
     // Crit chance modifiers need to be in here, not chaos_strike_damage_t.
@@ -3888,6 +3891,8 @@ struct chaos_cleave_t : public demon_hunter_attack_t
     radius = 8;
     range = -1.0;
     school = SCHOOL_CHAOS;
+    // snapshot_state() overrides the direct damage multiplier
+    batch_snapshot = false;
   }
 
   void snapshot_state(action_state_t* s, dmg_e rt) override
@@ -6668,50 +6673,51 @@ void demon_hunter_t::init_spells()
   }
 }
 
+// demon_hunter_t::init_cache_dependencies ==================================
+
+void demon_hunter_t::init_cache_dependencies()
+{
+  player_t::init_cache_dependencies();
+
+  if ( mastery_spell.demonic_presence -> ok() )
+    cache.add_dependency( CACHE_MASTERY, CACHE_RUN_SPEED );
+
+  if ( spec.riposte -> ok() )
+    cache.add_dependency( CACHE_CRIT_CHANCE, CACHE_PARRY );
+}
+
 // demon_hunter_t::invalidate_cache =========================================
 
 void demon_hunter_t::invalidate_cache( cache_e c )
 {
   player_t::invalidate_cache( c );
 
-  switch ( c )
+  if ( cache.invalidates( c, CACHE_MASTERY ) && buff.chaos_blades -> check() )
+    invalidate_cache( CACHE_PLAYER_DAMAGE_MULTIPLIER );
+
+  if ( cache.invalidates( c, CACHE_RUN_SPEED ) )
+    adjust_movement();
+
+  // Expression stuff
+  bool invalidate_blade_dance = cache.invalidates( c, CACHE_ATTACK_POWER ) ||
+                                cache.invalidates( c, CACHE_CRIT_CHANCE ) ||
+                                cache.invalidates( c, CACHE_DAMAGE_VERSATILITY ) ||
+                                cache.invalidates( c, CACHE_PLAYER_DAMAGE_MULTIPLIER );
+
+  if ( invalidate_blade_dance )
   {
-    case CACHE_MASTERY:
-      if ( mastery_spell.demonic_presence -> ok() )
-        invalidate_cache( CACHE_RUN_SPEED );
-      if ( buff.chaos_blades -> check() )
-        invalidate_cache( CACHE_PLAYER_DAMAGE_MULTIPLIER );
-      break;
-    case CACHE_CRIT_CHANCE:
-      if ( spec.riposte -> ok() )
-        invalidate_cache( CACHE_PARRY );
-      break;
-    case CACHE_RUN_SPEED:
-      adjust_movement();
-      break;
-    default:
-      break;
+    if ( blade_dance_dmg )
+      blade_dance_dmg -> invalidate();
+    if ( death_sweep_dmg )
+      death_sweep_dmg -> invalidate();
   }
 
-  // Expression stuff
-  switch ( c )
-  {
-    case CACHE_ATTACK_POWER:
-    case CACHE_CRIT_CHANCE:
-    case CACHE_DAMAGE_VERSATILITY:
-    case CACHE_PLAYER_DAMAGE_MULTIPLIER:
-      if ( blade_dance_dmg )
-        blade_dance_dmg -> invalidate();
-      if ( death_sweep_dmg )
-        death_sweep_dmg -> invalidate();
-    case CACHE_MASTERY:
-      if ( chaos_strike_dmg )
-        chaos_strike_dmg -> invalidate();
-      if ( annihilation_dmg )
-        annihilation_dmg -> invalidate();
-      break;
-    default:
-      break;
+  if ( invalidate_blade_dance || cache.invalidates( c, CACHE_MASTERY ) )
+  {
+    if ( chaos_strike_dmg )
+      chaos_strike_dmg -> invalidate();
+    if ( annihilation_dmg )
+      annihilation_dmg -> invalidate();
   }
 }
 
@@ -7577,7 +7583,7 @@ void demon_hunter_t::assess_damage_imminent_pre_absorb( school_e school,
       std::max( static_cast<unsigned>( cv * 100.0 ), ( unsigned ) 1 );
 
     buff.siphon_power -> trigger(
-      new_stack - buff.siphon_power -> current_stack, cv );
+      new_stack - buff.siphon_power -> check(), cv );
   }
 }
 
@@ -7633,6 +7639,7 @@ void demon_hunter_t::recalculate_resource_max( resource_e r )
 
         resources.max[ RESOURCE_HEALTH ] += diff;
         resources.temporary[ RESOURCE_HEALTH ] += diff;
+        resources.version++;
         if ( diff > 0 )
         {
           resource_gain( RESOURCE_HEALTH, diff );
@@ -7760,7 +7767,6 @@ void demon_hunter_t::adjust_movement()
   {
     // Recalculate movement duration.
     assert( buff.out_of_range -> value() > 0 );
-    assert( buff.out_of_range -> expiration.size() );
 
     timespan_t remains = buff.out_of_range -> remains();
     remains *= buff.out_of_range -> check_value() / cache.run_speed();
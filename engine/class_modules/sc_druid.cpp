@@ -825,6 +825,7 @@ public:
   std::string       default_potion() const override;
   std::string       default_food() const override;
   std::string       default_rune() const override;
+  virtual void      init_cache_dependencies() override;
   virtual void      invalidate_cache( cache_e ) override;
   virtual void      arise() override;
   virtual void      reset() override;
@@ -1270,7 +1271,10 @@ struct berserk_buff_base_t : public druid_buff_t<buff_t>
     bool success = druid_buff_t<buff_t>::trigger( stacks, value, chance, duration );
 
     if ( ! refresh && success )
+    {
       player -> resources.max[ RESOURCE_ENERGY ] += increased_max_energy;
+      player -> resources.version++;
+    }
 
     return success;
   }
@@ -1281,6 +1285,7 @@ struct berserk_buff_base_t : public druid_buff_t<buff_t>
     // Force energy down to cap if it's higher.
     player -> resources.current[ RESOURCE_ENERGY ] = std::min( player -> resources.current[ RESOURCE_ENERGY ],
         player -> resources.max[ RESOURCE_ENERGY ] );
+    player -> resources.version++;
 
     druid_buff_t<buff_t>::expire_override( expiration_stacks, remaining_duration );
   }
@@ -3025,6 +3030,8 @@ struct ashamanes_rip_t : public cat_attack_t
     may_miss = may_block = may_dodge = may_parry = false;
     // Copies benefit from rip, so need to flag this as snapshotting so its damage doesn't get modified dynamically.
     snapshots_tf = snapshots_sr = true;
+    // snapshot_state() copies the persistent multiplier from the rip on the target
+    batch_snapshot = false;
     // "dot_behavior" will have no effect, see ashamanes_rip_t::impact()
       
     base_tick_time *= 1.0 + p -> talent.jagged_wounds -> effectN( 1 ).percent();
@@ -3195,7 +3202,7 @@ struct ferocious_bite_t : public cat_attack_t
 
   bool ready() override
   {
-    if ( max_energy && p() -> resources.current[ RESOURCE_ENERGY ] < maximum_energy() )
+    if ( max_energy && p() -> resource_current( RESOURCE_ENERGY ) < maximum_energy() )
       return false;
 
     return cat_attack_t::ready();
@@ -3208,7 +3215,7 @@ struct ferocious_bite_t : public cat_attack_t
     max_excess_energy *= 1.0 + p() -> buff.incarnation_cat -> check_value();
 
     excess_energy = std::min( max_excess_energy,
-      ( p() -> resources.current[ RESOURCE_ENERGY ] - cat_attack_t::cost() ) );
+      ( p() -> resource_current( RESOURCE_ENERGY ) - cat_attack_t::cost() ) );
 
     cat_attack_t::execute();
 
@@ -4388,7 +4395,7 @@ struct healing_touch_t : public druid_heal_t
 
     timespan_t et = druid_heal_t::execute_time();
 
-    et *= 1.0 + p() -> buff.power_of_elune -> current_stack
+    et *= 1.0 + p() -> buff.power_of_elune -> check()
       * p() -> buff.power_of_elune -> data().effectN( 2 ).percent();
 
     return et;
@@ -4398,7 +4405,7 @@ struct healing_touch_t : public druid_heal_t
   {
     double am = druid_heal_t::action_multiplier();
 
-    am *= 1.0 + p() -> buff.power_of_elune -> current_stack
+    am *= 1.0 + p() -> buff.power_of_elune -> check()
       * p() -> buff.power_of_elune -> data().effectN( 1 ).percent();
 
     return am;
@@ -4580,7 +4587,7 @@ struct regrowth_t: public druid_heal_t
 
     timespan_t et = druid_heal_t::execute_time();
 
-    et *= 1.0 + p() -> buff.power_of_elune -> current_stack
+    et *= 1.0 + p() -> buff.power_of_elune -> check()
       * p() -> buff.power_of_elune -> data().effectN( 2 ).percent();
 
     return et;
@@ -4590,7 +4597,7 @@ struct regrowth_t: public druid_heal_t
   {
     double am = druid_heal_t::action_multiplier();
 
-    am *= 1.0 + p() -> buff.power_of_elune -> current_stack
+    am *= 1.0 + p() -> buff.power_of_elune -> check()
       * p() -> buff.power_of_elune -> data().effectN( 1 ).percent();
 
     return am;
@@ -8163,7 +8170,7 @@ timespan_t druid_t::available() const
   if ( primary_resource() != RESOURCE_ENERGY )
     return timespan_t::from_seconds( 0.1 );
 
-  double energy = resources.current[ RESOURCE_ENERGY ];
+  double energy = resource_current( RESOURCE_ENERGY );
 
   if ( energy > 25 ) return timespan_t::from_seconds( 0.1 );
 
@@ -8228,35 +8235,35 @@ void druid_t::recalculate_resource_max( resource_e rt )
   }
 }
 
+// druid_t::init_cache_dependencies =========================================
+
+void druid_t::init_cache_dependencies()
+{
+  player_t::init_cache_dependencies();
+
+  if ( spec.nurturing_instinct -> ok() )
+    cache.add_dependency( CACHE_ATTACK_POWER, CACHE_SPELL_POWER );
+
+  if ( mastery.natures_guardian -> ok() )
+    cache.add_dependency( CACHE_MASTERY, CACHE_ATTACK_POWER );
+
+  if ( specialization() == DRUID_GUARDIAN )
+    cache.add_dependency( CACHE_CRIT_CHANCE, CACHE_DODGE );
+}
+
 // druid_t::invalidate_cache ================================================
 
 void druid_t::invalidate_cache( cache_e c )
 {
   player_t::invalidate_cache( c );
 
-  switch ( c )
-  {
-  case CACHE_ATTACK_POWER:
-    if ( spec.nurturing_instinct -> ok() )
-      invalidate_cache( CACHE_SPELL_POWER );
-    break;
-  case CACHE_INTELLECT:
-    if ( spec.killer_instinct -> ok() && ( buff.cat_form -> check() || buff.bear_form -> check() ) )
-      invalidate_cache( CACHE_AGILITY );
-    break;
-  case CACHE_MASTERY:
-    if ( mastery.natures_guardian -> ok() )
-    {
-      invalidate_cache( CACHE_ATTACK_POWER );
-      recalculate_resource_max( RESOURCE_HEALTH );
-    }
-    break;
-  case CACHE_CRIT_CHANCE:
-    if ( specialization() == DRUID_GUARDIAN )
-      invalidate_cache( CACHE_DODGE );
-  default:
-    break;
-  }
+  // Killer Instinct only converts intellect in cat and bear form
+  if ( spec.killer_instinct -> ok() && cache.invalidates( c, CACHE_INTELLECT ) &&
+       ( buff.cat_form -> check() || buff.bear_form -> check() ) )
+    invalidate_cache( CACHE_AGILITY );
+
+  if ( mastery.natures_guardian -> ok() && cache.invalidates( c, CACHE_MASTERY ) )
+    recalculate_resource_max( RESOURCE_HEALTH );
 }
 
 // druid_t::composite_attack_power_multiplier ===============================
@@ -1640,11 +1640,11 @@ expr_t* enemy_t::create_expression( action_t* action,
         double evaluate() override
         {
           if ( debuff_str == "damage_taken" )
-            return boss -> sim -> actor_list[ boss -> current_target ] -> debuffs.damage_taken -> current_stack;
+            return boss -> sim -> actor_list[ boss -> current_target ] -> debuffs.damage_taken -> check();
           //else if ( debuff_str == "vulnerable" )
-          //  return boss -> sim -> actor_list[ boss -> current_target ] -> debuffs.vulnerable -> current_stack;
+          //  return boss -> sim -> actor_list[ boss -> current_target ] -> debuffs.vulnerable -> check();
           //else if ( debuff_str == "mortal_wounds" )
-          //  return boss -> sim -> actor_list[ boss -> current_target ] -> debuffs.mortal_wounds -> current_stack;
+          //  return boss -> sim -> actor_list[ boss -> current_target ] -> debuffs.mortal_wounds -> check();
           // may add others here as desired
           else
             return 0;
@@ -496,6 +496,7 @@ public:
   void      reset() override;
 
   void      regen( timespan_t periodicity = timespan_t::from_seconds( 0.25 ) ) override;
+  double    resource_regen_per_second( resource_e ) const override;
   double    composite_attack_power_multiplier() const override;
   double    composite_melee_crit_chance() const override;
   double    composite_spell_crit_chance() const override;
@@ -508,6 +509,7 @@ public:
   double    composite_player_target_multiplier( player_t* target, school_e school ) const override;
   double    composite_player_pet_damage_multiplier( const action_state_t* ) const override;
   double    matching_gear_multiplier( attribute_e attr ) const override;
+  void      init_cache_dependencies() override;
   void      invalidate_cache( cache_e ) override;
   void      create_options() override;
   expr_t*   create_expression( action_t*, const std::string& name ) override;
@@ -1274,6 +1276,14 @@ public:
   double focus_regen_per_second() const override
   { return o() -> focus_regen_per_second() * 1.25; }
 
+  double resource_regen_per_second( resource_e r ) const override
+  {
+    double rate = hunter_pet_t::resource_regen_per_second( r );
+    if ( r == RESOURCE_FOCUS && o() -> buffs.steady_focus -> check() )
+      rate += focus_regen_per_second() * o() -> buffs.steady_focus -> check_value();
+    return rate;
+  }
+
   double composite_melee_speed() const override
   {
     double ah = base_t::composite_melee_speed();
@@ -2107,7 +2117,7 @@ struct basic_attack_base_t: public hunter_main_pet_attack_t
   bool use_wild_hunt() const
   {
     // comment out to avoid procs
-    return p() -> resources.current[RESOURCE_FOCUS] > 50;
+    return p() -> resource_current( RESOURCE_FOCUS ) > 50;
   }
 
   void impact( action_state_t* s ) override
@@ -2597,7 +2607,7 @@ struct auto_shot_t: public hunter_action_t < ranged_attack_t >
 
     if (p()->buffs.volley->up())
     {
-      if (p()->resources.current[RESOURCE_FOCUS] > volley_tick_cost)
+      if (p()->resource_current( RESOURCE_FOCUS ) > volley_tick_cost)
       {
         volley_tick->target = execute_state->target;
         volley_tick->execute();
@@ -3589,7 +3599,7 @@ struct piercing_shot_t: public hunter_ranged_attack_t
   {
     double am = hunter_ranged_attack_t::action_multiplier();
 
-    am *= std::min( 100.0, p() -> resources.current[RESOURCE_FOCUS] ) / 100;
+    am *= std::min( 100.0, p() -> resource_current( RESOURCE_FOCUS ) ) / 100;
 
     return am;
   }
@@ -6527,6 +6537,16 @@ void hunter_t::regen( timespan_t periodicity )
   }
 }
 
+// hunter_t::resource_regen_per_second ======================================
+
+double hunter_t::resource_regen_per_second( resource_e r ) const
+{
+  double rate = player_t::resource_regen_per_second( r );
+  if ( r == RESOURCE_FOCUS && buffs.steady_focus -> check() )
+    rate += focus_regen_per_second() * buffs.steady_focus -> check_value();
+  return rate;
+}
+
 // hunter_t::composite_attack_power_multiplier ==============================
 
 double hunter_t::composite_attack_power_multiplier() const
@@ -6710,7 +6730,7 @@ double hunter_t::composite_player_pet_damage_multiplier( const action_state_t* s
     m *= 1.0 + buffs.the_mantle_of_command -> check_value();
 
   if ( buffs.parsels_tongue -> up() )
-    m *= 1.0 + buffs.parsels_tongue -> data().effectN( 2 ).percent() * buffs.parsels_tongue -> current_stack;
+    m *= 1.0 + buffs.parsels_tongue -> data().effectN( 2 ).percent() * buffs.parsels_tongue -> check();
 
   return m;
 }
@@ -6724,29 +6744,30 @@ double hunter_t::composite_mastery_value() const
   return m;
 }
 
+// hunter_t::init_cache_dependencies ========================================
+
+void hunter_t::init_cache_dependencies()
+{
+  player_t::init_cache_dependencies();
+
+  if ( mastery.sniper_training -> ok() )
+    cache.add_dependency( CACHE_MASTERY, CACHE_PLAYER_DAMAGE_MULTIPLIER );
+}
+
 // hunter_t::invalidate_cache ==============================================
 
 void hunter_t::invalidate_cache( cache_e c )
 {
   player_t::invalidate_cache( c );
 
-  switch ( c )
+  if ( mastery.sniper_training -> ok() && sim -> distance_targeting_enabled &&
+       cache.invalidates( c, CACHE_MASTERY ) )
   {
-  case CACHE_MASTERY:
-    if ( mastery.sniper_training -> ok() )
+    // Marksman is a unique butterfly, since mastery changes the max range of abilities. We need to regenerate every target cache.
+    for ( size_t i = 0, end = action_list.size(); i < end; i++ )
     {
-      player_t::invalidate_cache( CACHE_PLAYER_DAMAGE_MULTIPLIER );
-      if ( sim -> distance_targeting_enabled && mastery.sniper_training -> ok() )
-      {
-        // Marksman is a unique butterfly, since mastery changes the max range of abilities. We need to regenerate every target cache.
-        for ( size_t i = 0, end = action_list.size(); i < end; i++ )
-        {
-          action_list[i] -> target_cache.is_valid = false;
-        }
-      }
+      action_list[i] -> target_cache.is_valid = false;
     }
-    break;
-  default: break;
   }
 }
 
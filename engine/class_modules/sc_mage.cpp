@@ -566,6 +566,7 @@ public:
   virtual void        init_procs() override;
   virtual void        init_benefits() override;
   virtual void        init_assessors() override;
+  virtual void        init_cache_dependencies() override;
   virtual void        invalidate_cache( cache_e c ) override;
   virtual void        init_resources( bool force ) override;
   virtual void        recalculate_resource_max( resource_e rt ) override;
@@ -1107,7 +1108,7 @@ struct arcane_missiles_t : public buff_t
 
     if ( p -> talents.words_of_power -> ok() )
     {
-      double mult = p -> resources.pct( RESOURCE_MANA ) /
+      double mult = p -> resource_current( RESOURCE_MANA ) / p -> resources.max[ RESOURCE_MANA ] /
                     p -> talents.words_of_power -> effectN( 2 ).percent();
       am_proc_chance += mult * p -> talents.words_of_power -> effectN( 1 ).percent();
     }
@@ -2828,6 +2829,8 @@ struct arcane_missiles_t : public arcane_mage_spell_t
     hasted_ticks      = false;
     dynamic_tick_action = true;
     tick_action = new arcane_missiles_tick_t( p );
+    // Rule of Threes is rolled in snapshot_state()
+    batch_snapshot = false;
 
     base_multiplier *= 1.0 + p -> artifact.aegwynns_fury.percent();
     base_crit += p -> artifact.aegwynns_intensity.percent();
@@ -7757,33 +7760,29 @@ double mage_t::mana_regen_per_second() const
   return mps;
 }
 
+// mage_t::init_cache_dependencies ==========================================
+
+void mage_t::init_cache_dependencies()
+{
+  player_t::init_cache_dependencies();
+
+  // Combustion makes mastery dependent on spell crit chance rating. Thus
+  // any spell_crit_chance invalidation (which should include any
+  // spell_crit_rating changes) will also invalidate mastery.
+  if ( specialization() == MAGE_FIRE )
+    cache.add_dependency( CACHE_SPELL_CRIT_CHANCE, CACHE_MASTERY );
+}
+
 // mage_t::invalidate_cache ===================================================
 
 void mage_t::invalidate_cache( cache_e c )
 {
   player_t::invalidate_cache( c );
 
-  switch ( c )
+  if ( spec.savant -> ok() && cache.invalidates( c, CACHE_MASTERY ) )
   {
-    case CACHE_MASTERY:
-      if ( spec.savant -> ok() )
-      {
-        recalculate_resource_max( RESOURCE_MANA );
-      }
-      break;
-    case CACHE_SPELL_CRIT_CHANCE:
-      // Combustion makes mastery dependent on spell crit chance rating. Thus
-      // any spell_crit_chance invalidation (which should include any
-      // spell_crit_rating changes) will also invalidate mastery.
-      if ( specialization() == MAGE_FIRE )
-      {
-        invalidate_cache( CACHE_MASTERY );
-      }
-      break;
-    default:
-      break;
+    recalculate_resource_max( RESOURCE_MANA );
   }
-
 }
 
 // mage_t::recalculate_resource_max ===========================================
@@ -7795,6 +7794,11 @@ void mage_t::recalculate_resource_max( resource_e rt )
     return player_t::recalculate_resource_max( rt );
   }
 
+  // Bring mana up to date before taking the percentage, regeneration up to now is capped by the
+  // old maximum
+  if ( analytic_regen )
+    do_dynamic_regen();
+
   double current_mana = resources.current[ rt ],
          current_mana_max = resources.max[ rt ],
          mana_percent = current_mana / current_mana_max;
@@ -830,7 +830,7 @@ public:
   virtual void      assess_damage( school_e, dmg_e, action_state_t* s ) override;
   virtual void      assess_damage_imminent_pre_absorb( school_e, dmg_e, action_state_t* s ) override;
   virtual void      assess_heal( school_e, dmg_e, action_state_t* s) override;
-  virtual void      invalidate_cache( cache_e ) override;
+  virtual void      init_cache_dependencies() override;
   virtual void      init_action_list() override;
   void              activate() override;
   virtual bool      has_t18_class_trinket() const override;
@@ -3618,7 +3618,7 @@ struct blackout_kick_t: public monk_melee_attack_t
 
       if ( p() -> buff.teachings_of_the_monastery -> up() )
       {
-        int stacks = p() -> buff.teachings_of_the_monastery -> current_stack;
+        int stacks = p() -> buff.teachings_of_the_monastery -> check();
         p() -> buff.teachings_of_the_monastery -> expire();
 
         for (int i = 0; i < stacks; i++ )
@@ -4605,6 +4605,9 @@ struct keg_smash_t: public monk_melee_attack_t
 
     if ( p.artifact.stave_off.rank() )
       add_child( stave_off );
+
+    // Secret Ingredients makes Keg Smash usable while on cooldown, see ready()
+    ready_ignores_cooldown = true;
   }
 
   virtual bool ready() override
@@ -5333,7 +5336,7 @@ struct crackling_jade_lightning_t: public monk_spell_t
     double c = monk_spell_t::cost_per_tick( resource );
 
     if ( p() -> buff.the_emperors_capacitor -> up() && resource == RESOURCE_ENERGY )
-      c *= 1 + ( p() -> buff.the_emperors_capacitor -> current_stack * p() -> passives.the_emperors_capacitor -> effectN( 2 ).percent() );
+      c *= 1 + ( p() -> buff.the_emperors_capacitor -> check() * p() -> passives.the_emperors_capacitor -> effectN( 2 ).percent() );
 
     return c;
   }
@@ -5343,7 +5346,7 @@ struct crackling_jade_lightning_t: public monk_spell_t
     double c = monk_spell_t::cost();
 
     if ( p() -> buff.the_emperors_capacitor -> up() )
-      c *= 1 + ( p() -> buff.the_emperors_capacitor -> current_stack * p() -> passives.the_emperors_capacitor -> effectN( 2 ).percent() );
+      c *= 1 + ( p() -> buff.the_emperors_capacitor -> check() * p() -> passives.the_emperors_capacitor -> effectN( 2 ).percent() );
 
     return c;
   }
@@ -5638,10 +5641,10 @@ struct stagger_self_damage_t : public residual_action::residual_periodic_action_
     dot_t* d = get_dot();
     if ( d -> is_ticking() )
     {
-      if ( d -> tick_event )
-        d -> tick_event -> reschedule( d -> tick_event -> remains() + seconds );
+      if ( d -> tick_scheduled() )
+        d -> reschedule_tick( d -> time_to_next_tick() + seconds );
       if ( d -> end_event )
-        d -> end_event -> reschedule( d -> tick_event -> remains() + seconds );
+        d -> end_event -> reschedule( d -> time_to_next_tick() + seconds );
     }
   }
 
@@ -9109,7 +9112,7 @@ double monk_t::composite_dodge() const
     d += buff.brew_stache -> value();
 
   if ( buff.elusive_brawler -> up() )
-    d += buff.elusive_brawler -> current_stack * cache.mastery_value();
+    d += buff.elusive_brawler -> check() * cache.mastery_value();
 
   if ( buff.elusive_dance -> up() )
     d += buff.elusive_dance -> stack_value();
@@ -9214,28 +9217,20 @@ double monk_t::passive_movement_modifier() const
   return ms;
 }
 
-// monk_t::invalidate_cache ==============================================
+// monk_t::init_cache_dependencies ==========================================
 
-void monk_t::invalidate_cache( cache_e c )
+void monk_t::init_cache_dependencies()
 {
-  base_t::invalidate_cache( c );
+  player_t::init_cache_dependencies();
 
-  switch ( c )
-  {
-  case CACHE_SPELL_POWER:
-    if ( specialization() == MONK_MISTWEAVER )
-      player_t::invalidate_cache( CACHE_ATTACK_POWER );
-    break;
-  case CACHE_BONUS_ARMOR:
-    if ( spec.bladed_armor -> ok() )
-      player_t::invalidate_cache( CACHE_ATTACK_POWER );
-    break;
-  case CACHE_MASTERY:
-    if ( specialization() == MONK_WINDWALKER )
-      player_t::invalidate_cache( CACHE_PLAYER_DAMAGE_MULTIPLIER );
-    break;
-  default: break;
-  }
+  if ( specialization() == MONK_MISTWEAVER )
+    cache.add_dependency( CACHE_SPELL_POWER, CACHE_ATTACK_POWER );
+
+  if ( spec.bladed_armor -> ok() )
+    cache.add_dependency( CACHE_BONUS_ARMOR, CACHE_ATTACK_POWER );
+
+  if ( specialization() == MONK_WINDWALKER )
+    cache.add_dependency( CACHE_MASTERY, CACHE_PLAYER_DAMAGE_MULTIPLIER );
 }
 
 
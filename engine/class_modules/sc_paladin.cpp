@@ -476,6 +476,8 @@ public:
 
     beacon_target = nullptr;
     regen_type = REGEN_DYNAMIC;
+    // Guarded by the Light / Sword of Light mana is restored in periodic chunks
+    linear_regen = false;
   }
 
   virtual void      init_base_stats() override;
@@ -525,7 +527,7 @@ public:
   virtual void      assess_heal( school_e, dmg_e, action_state_t* ) override;
   virtual void      target_mitigation( school_e, dmg_e, action_state_t* ) override;
 
-  virtual void      invalidate_cache( cache_e ) override;
+  virtual void      init_cache_dependencies() override;
   virtual void      create_options() override;
   virtual double    matching_gear_multiplier( attribute_e attr ) const override;
   virtual action_t* create_action( const std::string& name, const std::string& options_str ) override;
@@ -5911,10 +5913,10 @@ double paladin_t::composite_player_multiplier( school_e school ) const
     }
   }
 
-  m *= 1.0 + buffs.wings_of_liberty -> current_stack * buffs.wings_of_liberty -> current_value;
+  m *= 1.0 + buffs.wings_of_liberty -> check() * buffs.wings_of_liberty -> current_value;
 
   if ( retribution_trinket )
-    m *= 1.0 + buffs.retribution_trinket -> current_stack * buffs.retribution_trinket -> current_value;
+    m *= 1.0 + buffs.retribution_trinket -> check() * buffs.retribution_trinket -> current_value;
 
   // WoD Ret PvP 4-piece buffs everything
   if ( buffs.vindicators_fury -> check() )
@@ -5926,7 +5928,7 @@ double paladin_t::composite_player_multiplier( school_e school ) const
     // Last defender gives the same amount of damage increase as it gives mitigation.
     // Mitigation is 0.97^n, or (1-0.03)^n, where the 0.03 is in the spell data.
     // The damage buff is then 1+(1-0.97^n), or 2-(1-0.03)^n.
-    m *= 2.0 - std::pow( 1.0 - talents.last_defender -> effectN( 2 ).percent(), buffs.last_defender -> current_stack );
+    m *= 2.0 - std::pow( 1.0 - talents.last_defender -> effectN( 2 ).percent(), buffs.last_defender -> check() );
   }
 
   // artifacts
@@ -6148,7 +6150,7 @@ void paladin_t::target_mitigation( school_e school,
   if ( talents.last_defender -> ok() )
   {
     // Last Defender gives a multiplier of 0.97^N - coded using spell data in case that changes
-    s -> result_amount *= std::pow( 1.0 - talents.last_defender -> effectN( 2 ).percent(), buffs.last_defender -> current_stack );
+    s -> result_amount *= std::pow( 1.0 - talents.last_defender -> effectN( 2 ).percent(), buffs.last_defender -> check() );
   }
 
   // heathcliffs
@@ -6281,33 +6283,33 @@ void paladin_t::target_mitigation( school_e school,
   }
 }
 
-// paladin_t::invalidate_cache ==============================================
+// paladin_t::init_cache_dependencies =======================================
 
-void paladin_t::invalidate_cache( cache_e c )
+void paladin_t::init_cache_dependencies()
 {
-  player_t::invalidate_cache( c );
+  player_t::init_cache_dependencies();
 
-  if ( ( passives.sword_of_light -> ok() || specialization() == PALADIN_RETRIBUTION || passives.guarded_by_the_light -> ok() || passives.divine_bulwark -> ok() )
-       && ( c == CACHE_STRENGTH || c == CACHE_ATTACK_POWER )
-     )
+  if ( passives.sword_of_light -> ok() || specialization() == PALADIN_RETRIBUTION ||
+       passives.guarded_by_the_light -> ok() || passives.divine_bulwark -> ok() )
   {
-    player_t::invalidate_cache( CACHE_SPELL_POWER );
+    cache.add_dependency( CACHE_STRENGTH, CACHE_SPELL_POWER );
+    cache.add_dependency( CACHE_ATTACK_POWER, CACHE_SPELL_POWER );
   }
 
-  if ( c == CACHE_ATTACK_CRIT_CHANCE && specialization() == PALADIN_PROTECTION )
-    player_t::invalidate_cache( CACHE_PARRY );
+  if ( specialization() == PALADIN_PROTECTION )
+    cache.add_dependency( CACHE_ATTACK_CRIT_CHANCE, CACHE_PARRY );
 
-  if ( c == CACHE_BONUS_ARMOR && passives.bladed_armor -> ok() )
+  if ( passives.bladed_armor -> ok() )
   {
-    player_t::invalidate_cache( CACHE_ATTACK_POWER );
-    player_t::invalidate_cache( CACHE_SPELL_POWER );
+    cache.add_dependency( CACHE_BONUS_ARMOR, CACHE_ATTACK_POWER );
+    cache.add_dependency( CACHE_BONUS_ARMOR, CACHE_SPELL_POWER );
   }
 
-  if ( c == CACHE_MASTERY && passives.divine_bulwark -> ok() )
+  if ( passives.divine_bulwark -> ok() )
   {
-    player_t::invalidate_cache( CACHE_BLOCK );
-    player_t::invalidate_cache( CACHE_ATTACK_POWER );
-    player_t::invalidate_cache( CACHE_SPELL_POWER );
+    cache.add_dependency( CACHE_MASTERY, CACHE_BLOCK );
+    cache.add_dependency( CACHE_MASTERY, CACHE_ATTACK_POWER );
+    cache.add_dependency( CACHE_MASTERY, CACHE_SPELL_POWER );
   }
 }
 
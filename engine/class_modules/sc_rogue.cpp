@@ -742,6 +742,7 @@ struct rogue_t : public player_t
   void      arise() override;
   void      combat_begin() override;
   void      regen( timespan_t periodicity ) override;
+  double    resource_regen_per_second( resource_e ) const override;
   timespan_t available() const override;
   action_t* create_action( const std::string& name, const std::string& options ) override;
   expr_t*   create_expression( action_t* a, const std::string& name_str ) override;
@@ -8710,6 +8711,22 @@ void rogue_t::regen( timespan_t periodicity )
   }
 }
 
+// rogue_t::resource_regen_per_second =======================================
+
+double rogue_t::resource_regen_per_second( resource_e r ) const
+{
+  double rate = player_t::resource_regen_per_second( r );
+  if ( r != RESOURCE_ENERGY || resources.is_infinite( RESOURCE_ENERGY ) )
+    return rate;
+
+  if ( buffs.adrenaline_rush -> check() )
+    rate += energy_regen_per_second() * buffs.adrenaline_rush -> data().effectN( 1 ).percent();
+  else if ( buffs.t20_4pc_outlaw -> check() )
+    rate += energy_regen_per_second() * buffs.t20_4pc_outlaw -> data().effectN( 1 ).percent();
+
+  return rate;
+}
+
 // rogue_t::available =======================================================
 
 timespan_t rogue_t::available() const
@@ -8720,7 +8737,7 @@ timespan_t rogue_t::available() const
   }
   else
   {
-    double energy = resources.current[ RESOURCE_ENERGY ];
+    double energy = resource_current( RESOURCE_ENERGY );
 
     if ( energy > 25 )
       return timespan_t::from_seconds( 0.1 );
@@ -544,7 +544,7 @@ public:
   virtual double    matching_gear_multiplier( attribute_e attr ) const override;
   virtual double    composite_player_multiplier( school_e school ) const override;
   virtual double    composite_rating_multiplier( rating_e rating ) const override;
-  virtual void      invalidate_cache( cache_e ) override;
+  virtual void      init_cache_dependencies() override;
   virtual double    composite_spell_crit_chance() const override;
   virtual double    composite_spell_haste() const override;
   virtual double    composite_melee_haste() const override;
@@ -5930,18 +5930,14 @@ double warlock_t::composite_player_multiplier( school_e school ) const
   return m;
 }
 
-void warlock_t::invalidate_cache( cache_e c )
+// warlock_t::init_cache_dependencies =======================================
+
+void warlock_t::init_cache_dependencies()
 {
-  player_t::invalidate_cache( c );
+  player_t::init_cache_dependencies();
 
-  switch ( c )
-  {
-  case CACHE_MASTERY:
-    if ( mastery_spells.master_demonologist -> ok() )
-      player_t::invalidate_cache( CACHE_PLAYER_DAMAGE_MULTIPLIER );
-    break;
-  default: break;
-  }
+  if ( mastery_spells.master_demonologist -> ok() )
+    cache.add_dependency( CACHE_MASTERY, CACHE_PLAYER_DAMAGE_MULTIPLIER );
 }
 
 double warlock_t::composite_spell_crit_chance() const
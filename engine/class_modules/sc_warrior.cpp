@@ -578,7 +578,7 @@ public:
   void      moving() override;
   void      create_options() override;
   std::string      create_profile( save_e type ) override;
-  void      invalidate_cache( cache_e ) override;
+  void      init_cache_dependencies() override;
   double    temporary_movement_modifier() const override;
 
   void      default_apl_dps_precombat( const std::string& food, const std::string& potion );
@@ -4470,6 +4470,8 @@ struct taunt_t: public warrior_spell_t
   {
     parse_options( options_str );
     use_off_gcd = ignore_false_positive = true;
+    // Warlord's Challenge makes Taunt usable while on cooldown, see ready()
+    ready_ignores_cooldown = p -> talents.warlords_challenge -> ok();
   }
 
   void impact( action_state_t* s ) override
@@ -5916,7 +5918,7 @@ struct into_the_fray_callback_t
         buff_stacks_++;
       }
     }
-    if ( w -> buff.into_the_fray -> current_stack != as<int>(buff_stacks_) )
+    if ( w -> buff.into_the_fray -> check() != as<int>(buff_stacks_) )
     {
       w -> buff.into_the_fray -> expire();
       w -> buff.into_the_fray -> trigger( static_cast<int>( buff_stacks_ ) );
@@ -6002,7 +6004,7 @@ double warrior_t::composite_player_multiplier( school_e school ) const
 
   if ( buff.tornados_eye -> check() )
   {
-    m *= 1.0 + ( buff.tornados_eye -> current_stack * buff.tornados_eye -> data().effectN( 2 ).percent() );
+    m *= 1.0 + ( buff.tornados_eye -> check() * buff.tornados_eye -> data().effectN( 2 ).percent() );
   }
 
   if ( specialization() == WARRIOR_ARMS )
@@ -6359,7 +6361,7 @@ double warrior_t::temporary_movement_modifier() const
   }
   else if ( buff.tornados_eye -> up() )
   {
-    temporary = std::max( buff.tornados_eye -> current_stack * buff.tornados_eye -> data().effectN( 1 ).percent(), temporary );
+    temporary = std::max( buff.tornados_eye -> check() * buff.tornados_eye -> data().effectN( 1 ).percent(), temporary );
   }
   else if ( buff.frothing_berserker -> up() )
   {
@@ -6368,29 +6370,22 @@ double warrior_t::temporary_movement_modifier() const
   return temporary;
 }
 
-// warrior_t::invalidate_cache ==============================================
+// warrior_t::init_cache_dependencies =======================================
 
-void warrior_t::invalidate_cache( cache_e c )
+void warrior_t::init_cache_dependencies()
 {
-  player_t::invalidate_cache( c );
+  player_t::init_cache_dependencies();
 
   if ( mastery.critical_block -> ok() )
   {
-    if ( c == CACHE_MASTERY )
-    {
-      player_t::invalidate_cache( CACHE_BLOCK );
-      player_t::invalidate_cache( CACHE_CRIT_BLOCK );
-      player_t::invalidate_cache( CACHE_ATTACK_POWER );
-    }
-    if ( c == CACHE_CRIT_CHANCE )
-    {
-      player_t::invalidate_cache( CACHE_PARRY );
-    }
-  }
-  if ( c == CACHE_MASTERY && mastery.unshackled_fury -> ok() )
-  {
-    player_t::invalidate_cache( CACHE_PLAYER_DAMAGE_MULTIPLIER );
+    cache.add_dependency( CACHE_MASTERY, CACHE_BLOCK );
+    cache.add_dependency( CACHE_MASTERY, CACHE_CRIT_BLOCK );
+    cache.add_dependency( CACHE_MASTERY, CACHE_ATTACK_POWER );
+    cache.add_dependency( CACHE_CRIT_CHANCE, CACHE_PARRY );
   }
+
+  if ( mastery.unshackled_fury -> ok() )
+    cache.add_dependency( CACHE_MASTERY, CACHE_PLAYER_DAMAGE_MULTIPLIER );
 }
 
 // warrior_t::primary_role() ================================================
@@ -84,6 +84,15 @@
 # define __extern_always_inline extern __always_inline __attribute__(( __gnu_inline__ ))
 #endif
 
+// Thread local storage for trivially constructible objects
+#if defined( SC_VS ) && SC_VS < 14
+#  define SC_THREAD_LOCAL __declspec( thread )
+#elif defined( SC_GCC ) && SC_GCC < 40800
+#  define SC_THREAD_LOCAL __thread
+#else
+#  define SC_THREAD_LOCAL thread_local
+#endif
+
 // ==========================================================================
 // General Macros/Defines
 // ==========================================================================
@@ -32,6 +32,140 @@ namespace {
   potion_data_t potion_data_index;
   flask_data_t flask_data_index;
   food_data_t food_data_index;
+
+  // Points of each curve in data order, so curve lookups do not need to scan the full curve point
+  // table.
+  struct curve_point_index_t
+  {
+    std::unordered_map<unsigned, std::vector<const curve_point_t*>> curves;
+
+    curve_point_index_t( const curve_point_t* table )
+    {
+      for ( ; table -> curve_id != 0; ++table )
+        curves[ table -> curve_id ].push_back( table );
+    }
+
+    const std::vector<const curve_point_t*>* find( unsigned curve_id ) const
+    {
+      auto it = curves.find( curve_id );
+      return it != curves.end() ? &( it -> second ) : nullptr;
+    }
+  };
+
+  const curve_point_index_t& curve_point_index( bool ptr )
+  {
+#if SC_USE_PTR
+    static const curve_point_index_t ptr_index( &__ptr_curve_point_data[ 0 ] );
+    if ( ptr )
+      return ptr_index;
+#endif
+    ( void ) ptr;
+    static const curve_point_index_t live_index( &__curve_point_data[ 0 ] );
+    return live_index;
+  }
+
+  // Process-wide memoization of curve point values. Curve data is immutable, so results can be
+  // shared by all sims (and profilesets) of the process.
+  struct curve_value_key_t
+  {
+    bool     ptr;
+    unsigned curve_id;
+    double   point;
+
+    bool operator==( const curve_value_key_t& other ) const
+    { return ptr == other.ptr && curve_id == other.curve_id && point == other.point; }
+  };
+
+  struct curve_value_hash_t
+  {
+    size_t operator()( const curve_value_key_t& key ) const
+    {
+      size_t seed = std::hash<double>()( key.point );
+      cache::hash_combine( seed, key.curve_id );
+      cache::hash_combine( seed, key.ptr );
+      return seed;
+    }
+  };
+
+  cache::memo_t<curve_value_key_t, double, curve_value_hash_t> curve_value_cache;
+
+  // Process-wide memoization of scaled item stat blocks. The key holds every input of
+  // item_database::scaled_stat, so items with the same base data, bonus ids, and item level share
+  // a single stat block.
+  struct stat_block_key_t
+  {
+    bool     ptr;
+    unsigned new_ilevel;
+    unsigned item_level;
+    unsigned base_item_level;
+    int      level;
+    int      quality;
+    int      inventory_type;
+    int      item_class;
+    int      item_subclass;
+    std::array<int, MAX_ITEM_STAT> stat_type;
+    std::array<int, MAX_ITEM_STAT> stat_val;
+    std::array<int, MAX_ITEM_STAT> stat_alloc;
+    std::array<double, MAX_ITEM_STAT> stat_socket_mul;
+
+    stat_block_key_t( const item_t& item, const dbc_t& dbc, unsigned ilevel ) :
+      ptr( dbc.ptr ), new_ilevel( ilevel ), item_level( item.item_level() ),
+      base_item_level( item.base_item_level() ), level( item.parsed.data.level ),
+      quality( item.parsed.data.quality ), inventory_type( item.parsed.data.inventory_type ),
+      item_class( item.parsed.data.item_class ), item_subclass( item.parsed.data.item_subclass )
+    {
+      range::copy( item.parsed.data.stat_type_e, stat_type.begin() );
+      range::copy( item.parsed.data.stat_val, stat_val.begin() );
+      range::copy( item.parsed.data.stat_alloc, stat_alloc.begin() );
+      range::copy( item.parsed.data.stat_socket_mul, stat_socket_mul.begin() );
+    }
+
+    bool operator==( const stat_block_key_t& other ) const
+    {
+      return ptr == other.ptr && new_ilevel == other.new_ilevel && item_level == other.item_level &&
+             base_item_level == other.base_item_level && level == other.level &&
+             quality == other.quality && inventory_type == other.inventory_type &&
+             item_class == other.item_class && item_subclass == other.item_subclass &&
+             stat_type == other.stat_type && stat_val == other.stat_val &&
+             stat_alloc == other.stat_alloc && stat_socket_mul == other.stat_socket_mul;
+    }
+  };
+
+  struct stat_block_hash_t
+  {
+    size_t operator()( const stat_block_key_t& key ) const
+    {
+      size_t seed = key.ptr;
+      cache::hash_combine( seed, key.new_ilevel );
+      cache::hash_combine( seed, key.item_level );
+      cache::hash_combine( seed, key.base_item_level );
+      cache::hash_combine( seed, key.level );
+      cache::hash_combine( seed, key.quality );
+      cache::hash_combine( seed, key.inventory_type );
+      cache::hash_combine( seed, key.item_class );
+      cache::hash_combine( seed, key.item_subclass );
+      for ( size_t i = 0; i < MAX_ITEM_STAT; ++i )
+      {
+        cache::hash_combine( seed, key.stat_type[ i ] );
+        cache::hash_combine( seed, key.stat_val[ i ] );
+        cache::hash_combine( seed, key.stat_alloc[ i ] );
+        cache::hash_combine( seed, std::hash<double>()( key.stat_socket_mul[ i ] ) );
+      }
+      return seed;
+    }
+  };
+
+  cache::memo_t<stat_block_key_t, item_database::stat_block_t, stat_block_hash_t> stat_block_cache;
+
+  // Process-wide item templates loaded from the local item database, after item bonuses have been
+  // applied.
+  struct item_template_t
+  {
+    item_data_t data;
+    std::string name;
+  };
+
+  cache::memo_t<std::string, item_template_t> item_template_cache;
 }
 
 const item_name_description_t* dbc::item_name_descriptions( bool ptr )
@@ -474,34 +608,22 @@ const scaling_stat_distribution_t* dbc_t::scaling_stat_distribution( unsigned id
 
 std::pair<const curve_point_t*, const curve_point_t*> dbc_t::curve_point( unsigned curve_id, double value )
 {
-#if SC_USE_PTR
-  const curve_point_t* table = ptr ? &__ptr_curve_point_data[ 0 ]
-                                   : &__curve_point_data[ 0 ];
-#else
-  const curve_point_t* table = &__curve_point_data[ 0 ];
-#endif
-
   const curve_point_t* lower_bound = nullptr, * upper_bound = nullptr;
-  while ( table -> curve_id != 0 )
+  if ( auto points = curve_point_index( ptr ).find( curve_id ) )
   {
-    if ( table -> curve_id != curve_id )
+    for ( auto point : *points )
     {
-      table++;
-      continue;
-    }
-
-    if ( table -> val1 <= value )
-    {
-      lower_bound = table;
-    }
+      if ( point -> val1 <= value )
+      {
+        lower_bound = point;
+      }
 
-    if ( table -> val1 >= value )
-    {
-      upper_bound = table;
-      break;
+      if ( point -> val1 >= value )
+      {
+        upper_bound = point;
+        break;
+      }
     }
-
-    table++;
   }
 
   if ( lower_bound == nullptr )
@@ -527,9 +649,14 @@ item_data_t* item_data_t::find( unsigned id, bool ptr )
 
 double item_database::curve_point_value( dbc_t& dbc, unsigned curve_id, double point_value )
 {
-  auto curve_data = dbc.curve_point( curve_id, point_value );
+  curve_value_key_t key { dbc.ptr, curve_id, point_value };
 
   double scaled_result = 0;
+  if ( curve_value_cache.get( key, scaled_result ) )
+    return scaled_result;
+
+  auto curve_data = dbc.curve_point( curve_id, point_value );
+
   // Lands on a value, use data
   if ( curve_data.first -> val1 == point_value )
   {
@@ -557,6 +684,8 @@ double item_database::curve_point_value( dbc_t& dbc, unsigned curve_id, double p
       ( point_value - curve_data.first -> val1 ) / ( curve_data.second -> val1 - curve_data.first -> val1 );
   }
 
+  curve_value_cache.set( key, scaled_result );
+
   return scaled_result;
 }
 
@@ -986,6 +1115,24 @@ int item_database::scaled_stat( const item_t& item, const dbc_t& dbc, size_t idx
     return static_cast<int>( floor( item.parsed.data.stat_val[ idx ] * approx_scale_coefficient( item.parsed.data.level, new_ilevel ) ) );
 }
 
+// item_database_t::scaled_stats ============================================
+
+item_database::stat_block_t item_database::scaled_stats( const item_t& item, const dbc_t& dbc, unsigned new_ilevel )
+{
+  stat_block_key_t key( item, dbc, new_ilevel );
+
+  stat_block_t block;
+  if ( stat_block_cache.get( key, block ) )
+    return block;
+
+  for ( size_t i = 0; i < block.size(); ++i )
+    block[ i ] = scaled_stat( item, dbc, i, new_ilevel );
+
+  stat_block_cache.set( key, block );
+
+  return block;
+}
+
 // item_database_t::initialize_item_sources =================================
 
 bool item_database::initialize_item_sources( item_t& item, std::vector<std::string>& source_list )
@@ -1314,6 +1461,29 @@ bool item_database::parse_item_spell_enchant( item_t& item,
 
 bool item_database::load_item_from_data( item_t& item )
 {
+  // The resulting item data only depends on the item id, bonus ids, and the levels used for
+  // scaling. Debug output of the bonus application is only generated without the cache.
+  std::string template_key;
+  size_t n_errors = item.sim -> error_list.size();
+  if ( ! item.sim -> debug )
+  {
+    template_key = util::to_string( item.player -> dbc.ptr ) + ":" +
+                   util::to_string( item.parsed.data.id ) + ":" +
+                   util::to_string( item.player -> level() ) + ":" +
+                   util::to_string( item.parsed.drop_level );
+    for ( auto bonus_id : item.parsed.bonus_id )
+      template_key += ":" + util::to_string( bonus_id );
+
+    item_template_t entry;
+    if ( item_template_cache.get( template_key, entry ) )
+    {
+      item.parsed.data = entry.data;
+      item.name_str = entry.name;
+      item.parsed.data.name = item.name_str.c_str();
+      return true;
+    }
+  }
+
   // Simple copying of basic stats from item database (dbc) to the item object
   const item_data_t* data = item.player -> dbc.item( item.parsed.data.id );
   if ( ! data || ! data -> id ) return false;
@@ -1337,6 +1507,17 @@ bool item_database::load_item_from_data( item_t& item )
     }
   }
 
+  // Only cache items whose bonuses applied cleanly, so bonus errors are reported for every sim.
+  // Errors are only recorded by the main thread, so only it can tell.
+  if ( ! template_key.empty() && item.sim -> thread_index == 0 &&
+       item.sim -> error_list.size() == n_errors )
+  {
+    item_template_t entry;
+    entry.data = item.parsed.data;
+    entry.name = item.name_str;
+    item_template_cache.set( template_key, entry );
+  }
+
   return true;
 }
 
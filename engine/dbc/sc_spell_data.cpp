@@ -5,6 +5,7 @@
 
 #include "simulationcraft.hpp"
 #include "sim/sc_expressions.hpp"
+#include <thread>
 
 namespace { // anonymous namespace ==========================================
 
@@ -254,6 +255,304 @@ unsigned school_str_to_mask( const std::string& str )
   return mask;
 }
 
+// Columnar spell data index ================================================
+
+// Comparison operators supported by the column scanner. Bitmask operators are used by the class,
+// race, school, and attribute queries.
+enum sdata_scan_op_e
+{
+  SCAN_LT = 0,
+  SCAN_LTEQ,
+  SCAN_GT,
+  SCAN_GTEQ,
+  SCAN_EQ,
+  SCAN_NOTEQ,
+  SCAN_MASK_ANY,
+  SCAN_MASK_ALL,
+  SCAN_MASK_NONE,
+  SCAN_STR_EQ,
+  SCAN_STR_NOTEQ,
+  SCAN_STR_IN,
+  SCAN_STR_NOTIN
+};
+
+enum sdata_table_e
+{
+  TABLE_SPELL = 0,
+  TABLE_TALENT,
+  TABLE_EFFECT,
+  // (spell, effect) pairs in spell effect order, used by spell.effect.X queries
+  TABLE_SPELL_EFFECT,
+  TABLE_MAX
+};
+
+// A single field of a data table, extracted into a contiguous array so predicates can be
+// evaluated in a tight loop instead of through per-record offset arithmetic.
+struct sdata_column_t
+{
+  sdata_field_type_t       type;
+  std::vector<int>         v_int;
+  std::vector<unsigned>    v_unsigned;
+  std::vector<uint64_t>    v_uint64;
+  std::vector<double>      v_double;
+  std::vector<std::string> v_str;
+
+  sdata_column_t( sdata_field_type_t t ) : type( t )
+  { }
+};
+
+template <typename T>
+void scan_column( const std::vector<T>& col, T v, sdata_scan_op_e op,
+                  size_t begin, size_t end, uint8_t* out )
+{
+  const T* data = col.data();
+  switch ( op )
+  {
+    case SCAN_LT:    for ( size_t i = begin; i < end; ++i ) out[ i ] = data[ i ] <  v; break;
+    case SCAN_LTEQ:  for ( size_t i = begin; i < end; ++i ) out[ i ] = data[ i ] <= v; break;
+    case SCAN_GT:    for ( size_t i = begin; i < end; ++i ) out[ i ] = data[ i ] >  v; break;
+    case SCAN_GTEQ:  for ( size_t i = begin; i < end; ++i ) out[ i ] = data[ i ] >= v; break;
+    case SCAN_EQ:    for ( size_t i = begin; i < end; ++i ) out[ i ] = data[ i ] == v; break;
+    case SCAN_NOTEQ: for ( size_t i = begin; i < end; ++i ) out[ i ] = data[ i ] != v; break;
+    default:         for ( size_t i = begin; i < end; ++i ) out[ i ] = 0; break;
+  }
+}
+
+void scan_mask_column( const std::vector<unsigned>& col, unsigned v, sdata_scan_op_e op,
+                       size_t begin, size_t end, uint8_t* out )
+{
+  const unsigned* data = col.data();
+  switch ( op )
+  {
+    case SCAN_MASK_ANY:  for ( size_t i = begin; i < end; ++i ) out[ i ] = ( data[ i ] & v ) != 0; break;
+    case SCAN_MASK_ALL:  for ( size_t i = begin; i < end; ++i ) out[ i ] = ( data[ i ] & v ) == v; break;
+    case SCAN_MASK_NONE: for ( size_t i = begin; i < end; ++i ) out[ i ] = ( data[ i ] & v ) == 0; break;
+    default:             scan_column( col, v, op, begin, end, out ); break;
+  }
+}
+
+void scan_str_column( const std::vector<std::string>& col, const std::string& v, sdata_scan_op_e op,
+                      size_t begin, size_t end, uint8_t* out )
+{
+  for ( size_t i = begin; i < end; ++i )
+  {
+    switch ( op )
+    {
+      case SCAN_STR_EQ:    out[ i ] = util::str_compare_ci( col[ i ], v ); break;
+      case SCAN_STR_NOTEQ: out[ i ] = ! util::str_compare_ci( col[ i ], v ); break;
+      case SCAN_STR_IN:    out[ i ] = util::str_in_str_ci( col[ i ], v ); break;
+      case SCAN_STR_NOTIN: out[ i ] = ! util::str_in_str_ci( col[ i ], v ); break;
+      default:             out[ i ] = 0; break;
+    }
+  }
+}
+
+// Process-wide, read-only index of the spell, talent, and effect tables. Rows are sorted by id,
+// and columns are extracted lazily on first use so only the queried fields are ever materialized.
+class sdata_index_t
+{
+  struct table_t
+  {
+    std::vector<const char*> rows;
+    std::vector<uint32_t>    ids;
+    // TABLE_SPELL_EFFECT only: the spell table row of each (spell, effect) pair
+    std::vector<uint32_t>    owner;
+    std::map<size_t, std::unique_ptr<sdata_column_t>> columns;
+  };
+
+  std::array<table_t, TABLE_MAX> tables;
+  mutex_t mutex;
+
+  template <typename T>
+  static void init_table( table_t& table, const T* list )
+  {
+    std::vector<std::pair<uint32_t, const char*>> entries;
+    for ( const T* entry = list; entry -> id(); ++entry )
+      entries.push_back( std::make_pair( entry -> id(), reinterpret_cast<const char*>( entry ) ) );
+
+    range::sort( entries, []( const std::pair<uint32_t, const char*>& l, const std::pair<uint32_t, const char*>& r ) {
+      return l.first < r.first;
+    } );
+
+    table.ids.reserve( entries.size() );
+    table.rows.reserve( entries.size() );
+    for ( const auto& entry : entries )
+    {
+      table.ids.push_back( entry.first );
+      table.rows.push_back( entry.second );
+    }
+  }
+
+  sdata_index_t( bool ptr )
+  {
+    init_table( tables[ TABLE_SPELL ], spell_data_t::list( ptr ) );
+    init_table( tables[ TABLE_TALENT ], talent_data_t::list( ptr ) );
+    init_table( tables[ TABLE_EFFECT ], spelleffect_data_t::list( ptr ) );
+
+    // Flatten spell effects in the same order spell_data_t::effectN() would return them, skipping
+    // effects that do not resolve to valid effect data.
+    const table_t& spells = tables[ TABLE_SPELL ];
+    table_t& spell_effects = tables[ TABLE_SPELL_EFFECT ];
+    for ( size_t row = 0; row < spells.rows.size(); ++row )
+    {
+      const spell_data_t* spell = reinterpret_cast<const spell_data_t*>( spells.rows[ row ] );
+      for ( size_t i = 1; i <= spell -> effect_count(); ++i )
+      {
+        const spelleffect_data_t& effect = spell -> effectN( i );
+        if ( effect.id() == 0 || spelleffect_data_t::find( effect.id(), ptr ) -> id() == 0 )
+          continue;
+
+        spell_effects.rows.push_back( reinterpret_cast<const char*>( &effect ) );
+        spell_effects.ids.push_back( spell -> id() );
+        spell_effects.owner.push_back( as<uint32_t>( row ) );
+      }
+    }
+  }
+
+public:
+  static sdata_column_t* extract_column( const std::vector<const char*>& rows, sdata_field_type_t type, size_t offset )
+  {
+    auto column = new sdata_column_t( type );
+    size_t n_rows = rows.size();
+    switch ( type )
+    {
+      case SD_TYPE_INT:
+        column -> v_int.resize( n_rows );
+        for ( size_t i = 0; i < n_rows; ++i )
+          column -> v_int[ i ] = *reinterpret_cast<const int*>( rows[ i ] + offset );
+        break;
+      case SD_TYPE_UNSIGNED:
+        column -> v_unsigned.resize( n_rows );
+        for ( size_t i = 0; i < n_rows; ++i )
+          column -> v_unsigned[ i ] = *reinterpret_cast<const unsigned*>( rows[ i ] + offset );
+        break;
+      case SD_TYPE_UINT64:
+        column -> v_uint64.resize( n_rows );
+        for ( size_t i = 0; i < n_rows; ++i )
+          column -> v_uint64[ i ] = *reinterpret_cast<const uint64_t*>( rows[ i ] + offset );
+        break;
+      case SD_TYPE_DOUBLE:
+        column -> v_double.resize( n_rows );
+        for ( size_t i = 0; i < n_rows; ++i )
+          column -> v_double[ i ] = *reinterpret_cast<const double*>( rows[ i ] + offset );
+        break;
+      case SD_TYPE_STR:
+        column -> v_str.resize( n_rows );
+        for ( size_t i = 0; i < n_rows; ++i )
+        {
+          const char* c_str = *reinterpret_cast<const char * const*>( rows[ i ] + offset );
+          column -> v_str[ i ] = c_str ? c_str : "";
+          util::tokenize( column -> v_str[ i ] );
+        }
+        break;
+      default:
+        break;
+    }
+
+    return column;
+  }
+
+  static sdata_index_t& get( bool ptr )
+  {
+#if SC_USE_PTR
+    static sdata_index_t ptr_index( true );
+    if ( ptr )
+      return ptr_index;
+#endif
+    ( void ) ptr;
+    static sdata_index_t live_index( false );
+    return live_index;
+  }
+
+  size_t rows( sdata_table_e table ) const
+  { return tables[ table ].rows.size(); }
+
+  const std::vector<uint32_t>& ids( sdata_table_e table ) const
+  { return tables[ table ].ids; }
+
+  const std::vector<uint32_t>& owner( sdata_table_e table ) const
+  { return tables[ table ].owner; }
+
+  // Returns the table row of the given id, or -1 if the id is not in the table
+  int row( sdata_table_e table, uint32_t id ) const
+  {
+    const std::vector<uint32_t>& ids = tables[ table ].ids;
+    auto it = std::lower_bound( ids.begin(), ids.end(), id );
+    if ( it == ids.end() || *it != id )
+      return -1;
+
+    return static_cast<int>( it - ids.begin() );
+  }
+
+  const sdata_column_t& column( sdata_table_e table, sdata_field_type_t type, size_t offset )
+  {
+    AUTO_LOCK( mutex );
+
+    auto& col = tables[ table ].columns[ offset ];
+    if ( ! col )
+      col = std::unique_ptr<sdata_column_t>( extract_column( tables[ table ].rows, type, offset ) );
+
+    assert( col -> type == type );
+    return *col;
+  }
+};
+
+// Evaluate a predicate over all rows of a table column, producing a per-row match flag. Large
+// tables are split into contiguous chunks scanned by the sim's worker thread count.
+std::vector<uint8_t> scan_table( const sim_t* sim, const sdata_column_t& column, sdata_scan_op_e op,
+                                 double num, const std::string& str, size_t n_rows )
+{
+  std::vector<uint8_t> mask( n_rows, 0 );
+  uint8_t* out = mask.data();
+
+  auto scan = [ & ]( size_t begin, size_t end ) {
+    switch ( column.type )
+    {
+      case SD_TYPE_INT:
+        scan_column( column.v_int, static_cast<int>( num ), op, begin, end, out );
+        break;
+      case SD_TYPE_UNSIGNED:
+        scan_mask_column( column.v_unsigned, static_cast<unsigned>( num ), op, begin, end, out );
+        break;
+      case SD_TYPE_UINT64:
+        scan_column( column.v_uint64, static_cast<uint64_t>( num ), op, begin, end, out );
+        break;
+      case SD_TYPE_DOUBLE:
+        scan_column( column.v_double, num, op, begin, end, out );
+        break;
+      case SD_TYPE_STR:
+        scan_str_column( column.v_str, str, op, begin, end, out );
+        break;
+      default:
+        break;
+    }
+  };
+
+  // Numeric scans are memory bound and only worth splitting for the largest tables, string
+  // scans are considerably more expensive per row.
+  size_t min_chunk = column.type == SD_TYPE_STR ? 2048 : 65536;
+  size_t n_threads = std::max( 1, sim -> threads );
+  n_threads = std::min( n_threads, std::max<size_t>( 1, n_rows / min_chunk ) );
+
+  if ( n_threads == 1 )
+  {
+    scan( 0, n_rows );
+    return mask;
+  }
+
+  std::vector<std::thread> workers;
+  size_t chunk = ( n_rows + n_threads - 1 ) / n_threads;
+  for ( size_t begin = chunk; begin < n_rows; begin += chunk )
+    workers.emplace_back( scan, begin, std::min( n_rows, begin + chunk ) );
+
+  scan( 0, std::min( n_rows, chunk ) );
+
+  for ( auto& worker : workers )
+    worker.join();
+
+  return mask;
+}
+
 // Generic spell list based expression, holds intersection, union for list
 // For these expression types, you can only use two spell lists as parameters
 struct spell_list_expr_t : public spell_data_expr_t
@@ -261,6 +560,64 @@ struct spell_list_expr_t : public spell_data_expr_t
   spell_list_expr_t( sim_t* sim, const std::string& name, expr_data_e type = DATA_SPELL, bool eq = false ) :
     spell_data_expr_t( sim, name, type, eq, expression::TOK_SPELL_LIST ) { }
 
+  // Filter the current list through a predicate evaluated on the columnar spell data index. Ids
+  // that are not present in the table are evaluated against the table's nil entry, as a direct
+  // dbc lookup would return.
+  std::vector<uint32_t> filter( sdata_table_e table, sdata_field_type_t type, size_t offset,
+                                sdata_scan_op_e op, const spell_data_expr_t& other ) const
+  {
+    sdata_index_t& index = sdata_index_t::get( sim -> dbc.ptr );
+    std::vector<uint8_t> mask = scan_table( sim, index.column( table, type, offset ), op,
+                                            other.result_num, other.result_str, index.rows( table ) );
+
+    sdata_table_e lookup_table = table;
+    const char* nil = nullptr;
+    switch ( table )
+    {
+      case TABLE_TALENT: nil = reinterpret_cast<const char*>( talent_data_t::nil() ); break;
+      case TABLE_EFFECT: nil = reinterpret_cast<const char*>( spelleffect_data_t::nil() ); break;
+      case TABLE_SPELL:  nil = reinterpret_cast<const char*>( spell_data_t::nil() ); break;
+      // A spell matches an effect query if any of its effects match. The nil spell has no effects.
+      case TABLE_SPELL_EFFECT:
+      {
+        std::vector<uint8_t> spell_mask( index.rows( TABLE_SPELL ), 0 );
+        const std::vector<uint32_t>& owner = index.owner( table );
+        for ( size_t i = 0, end = mask.size(); i < end; ++i )
+          spell_mask[ owner[ i ] ] |= mask[ i ];
+        mask.swap( spell_mask );
+        lookup_table = TABLE_SPELL;
+        break;
+      }
+      default:
+        break;
+    }
+
+    int nil_match = -1;
+    std::vector<uint32_t> res;
+    for ( auto id : result_spell_list )
+    {
+      bool match = false;
+      int row = index.row( lookup_table, id );
+      if ( row >= 0 )
+        match = mask[ row ] != 0;
+      else if ( nil )
+      {
+        if ( nil_match == -1 )
+        {
+          std::unique_ptr<sdata_column_t> nil_column( sdata_index_t::extract_column( { nil }, type, offset ) );
+          nil_match = scan_table( sim, *nil_column, op, other.result_num, other.result_str, 1 ).front();
+        }
+        match = nil_match == 1;
+      }
+
+      // Input lists are sorted, so duplicates can only be adjacent
+      if ( match && ( res.empty() || res.back() != id ) )
+        res.push_back( id );
+    }
+
+    return res;
+  }
+
   virtual int evaluate() override
   {
     unsigned spell_id;
@@ -531,134 +888,31 @@ struct spell_data_filter_expr_t : public spell_list_expr_t
     }
   }
 
-  virtual bool compare( const char* data, const spell_data_expr_t& other, expression::token_e t ) const
-  {
-    switch ( field_type )
-    {
-      case SD_TYPE_INT:
-      {
-        int int_v  = *reinterpret_cast< const int* >( data + offset );
-        int oint_v = static_cast<int>( other.result_num );
-        switch ( t )
-        {
-          case expression::TOK_LT:     return int_v <  oint_v;
-          case expression::TOK_LTEQ:   return int_v <= oint_v;
-          case expression::TOK_GT:     return int_v >  oint_v;
-          case expression::TOK_GTEQ:   return int_v >= oint_v;
-          case expression::TOK_EQ:     return int_v == oint_v;
-          case expression::TOK_NOTEQ:  return int_v != oint_v;
-          default:         return false;
-        }
-        break;
-      }
-      case SD_TYPE_UNSIGNED:
-      {
-        unsigned unsigned_v  = *reinterpret_cast< const unsigned* >( data + offset );
-        unsigned ounsigned_v = static_cast<unsigned>( other.result_num );
-        switch ( t )
-        {
-          case expression::TOK_LT:     return unsigned_v <  ounsigned_v;
-          case expression::TOK_LTEQ:   return unsigned_v <= ounsigned_v;
-          case expression::TOK_GT:     return unsigned_v >  ounsigned_v;
-          case expression::TOK_GTEQ:   return unsigned_v >= ounsigned_v;
-          case expression::TOK_EQ:     return unsigned_v == ounsigned_v;
-          case expression::TOK_NOTEQ:  return unsigned_v != ounsigned_v;
-          default:         return false;
-        }
-        break;
-      }
-      case SD_TYPE_UINT64:
-      {
-        uint64_t unsigned_v  = *reinterpret_cast< const uint64_t* >( data + offset );
-        uint64_t ounsigned_v = static_cast<uint64_t>( other.result_num );
-        switch ( t )
-        {
-          case expression::TOK_LT:     return unsigned_v <  ounsigned_v;
-          case expression::TOK_LTEQ:   return unsigned_v <= ounsigned_v;
-          case expression::TOK_GT:     return unsigned_v >  ounsigned_v;
-          case expression::TOK_GTEQ:   return unsigned_v >= ounsigned_v;
-          case expression::TOK_EQ:     return unsigned_v == ounsigned_v;
-          case expression::TOK_NOTEQ:  return unsigned_v != ounsigned_v;
-          default:         return false;
-        }
-        break;
-      }
-      case SD_TYPE_DOUBLE:
-      {
-        double double_v = *reinterpret_cast<const double*>( data + offset );
-        switch ( t )
-        {
-          case expression::TOK_LT:     return double_v <  other.result_num;
-          case expression::TOK_LTEQ:   return double_v <= other.result_num;
-          case expression::TOK_GT:     return double_v >  other.result_num;
-          case expression::TOK_GTEQ:   return double_v >= other.result_num;
-          case expression::TOK_EQ:     return double_v == other.result_num;
-          case expression::TOK_NOTEQ:  return double_v != other.result_num;
-          default:         return false;
-        }
-        break;
-      }
-      case SD_TYPE_STR:
-      {
-        const char* c_str = *reinterpret_cast<const char * const*>( data + offset );
-        std::string string_v = c_str ? c_str : "";
-        util::tokenize( string_v );
-        const std::string& ostring_v = other.result_str;
-
-        switch ( t )
-        {
-          case expression::TOK_EQ:    return util::str_compare_ci( string_v, ostring_v );
-          case expression::TOK_NOTEQ: return ! util::str_compare_ci( string_v, ostring_v );
-          case expression::TOK_IN:    return util::str_in_str_ci( string_v, ostring_v );
-          case expression::TOK_NOTIN: return ! util::str_in_str_ci( string_v, ostring_v );
-          default:        return false;
-        }
-        break;
-      }
-      default:
-        break;
-    }
-    return false;
-  }
-
   void build_list( std::vector<uint32_t>& res, const spell_data_expr_t& other, expression::token_e t ) const
   {
-    for ( auto i = result_spell_list.begin(); i != result_spell_list.end(); ++i )
+    sdata_scan_op_e op;
+    switch ( t )
     {
-      // Don't bother comparing if this spell id is already in the result set.
-      if ( range::find( res, *i ) != res.end() )
-        continue;
-
-      if ( effect_query )
-      {
-        const spell_data_t& spell = *sim -> dbc.spell( *i );
+      case expression::TOK_LT:    op = SCAN_LT; break;
+      case expression::TOK_LTEQ:  op = SCAN_LTEQ; break;
+      case expression::TOK_GT:    op = SCAN_GT; break;
+      case expression::TOK_GTEQ:  op = SCAN_GTEQ; break;
+      case expression::TOK_EQ:    op = field_type == SD_TYPE_STR ? SCAN_STR_EQ : SCAN_EQ; break;
+      case expression::TOK_NOTEQ: op = field_type == SD_TYPE_STR ? SCAN_STR_NOTEQ : SCAN_NOTEQ; break;
+      case expression::TOK_IN:    op = SCAN_STR_IN; break;
+      case expression::TOK_NOTIN: op = SCAN_STR_NOTIN; break;
+      default:                    return;
+    }
 
-        // Compare against every spell effect
-        for ( size_t j = 0; j < spell.effect_count(); j++ )
-        {
-          const spelleffect_data_t& effect = spell.effectN( j + 1 );
+    sdata_table_e table = TABLE_SPELL;
+    if ( effect_query )
+      table = TABLE_SPELL_EFFECT;
+    else if ( data_type == DATA_TALENT )
+      table = TABLE_TALENT;
+    else if ( data_type == DATA_EFFECT )
+      table = TABLE_EFFECT;
 
-          if ( effect.id() > 0 && sim -> dbc.effect( effect.id() ) &&
-               compare( reinterpret_cast<const char*>( &effect ), other, t ) )
-          {
-            res.push_back( *i );
-            break;
-          }
-        }
-      }
-      else
-      {
-        const char* p_data;
-        if ( data_type == DATA_TALENT )
-          p_data = reinterpret_cast<const char*>( sim -> dbc.talent( *i ) );
-        else if ( data_type == DATA_EFFECT )
-          p_data = reinterpret_cast<const char*>( sim -> dbc.effect( *i ) );
-        else
-          p_data = reinterpret_cast<const char*>( sim -> dbc.spell( *i ) );
-        if ( p_data && compare( p_data, other, t ) )
-          res.push_back( *i );
-      }
-    }
+    res = filter( table, field_type, offset, op, other );
   }
 
   virtual std::vector<uint32_t> operator==( const spell_data_expr_t& other ) override
@@ -820,138 +1074,49 @@ struct spell_class_expr_t : public spell_list_expr_t
 {
   spell_class_expr_t( sim_t* sim, expr_data_e type ) : spell_list_expr_t( sim, "class", type ) { }
 
-  virtual std::vector<uint32_t> operator==( const spell_data_expr_t& other ) override
+  std::vector<uint32_t> filter_class( const spell_data_expr_t& other, sdata_scan_op_e op ) const
   {
-    std::vector<uint32_t> res;
-    uint32_t              class_mask;
-
-    if ( other.result_tok == expression::TOK_STR )
-      class_mask = class_str_to_mask( other.result_str );
     // Other types will not be allowed, e.g. you cannot do class=list
-    else
-      return res;
-
-    for ( std::vector<uint32_t>::const_iterator i = result_spell_list.begin(); i != result_spell_list.end(); ++i )
-    {
-      if ( data_type == DATA_TALENT )
-      {
-        if ( ! sim -> dbc.talent( *i ) )
-          continue;
-
-        if ( sim -> dbc.talent( *i ) -> mask_class() & class_mask )
-          res.push_back( *i );
-      }
-      else
-      {
-        const spell_data_t* spell = sim -> dbc.spell( *i );
+    if ( other.result_tok != expression::TOK_STR )
+      return std::vector<uint32_t>();
 
-        if ( ! spell )
-          continue;
-
-        if ( spell -> class_mask() & class_mask )
-          res.push_back( *i );
-      }
-    }
-
-    return res;
-  }
-
-  virtual std::vector<uint32_t> operator!=( const spell_data_expr_t& other ) override
-  {
-    std::vector<uint32_t> res;
-    uint32_t              class_mask;
-
-    if ( other.result_tok == expression::TOK_STR )
-      class_mask = class_str_to_mask( other.result_str );
-    // Other types will not be allowed, e.g. you cannot do class=list
+    spell_data_expr_t mask( sim, other.name_str, class_str_to_mask( other.result_str ) );
+    if ( data_type == DATA_TALENT )
+      return filter( TABLE_TALENT, SD_TYPE_UNSIGNED, O_TD( _m_class ), op, mask );
     else
-      return res;
-
-    for ( std::vector<uint32_t>::const_iterator i = result_spell_list.begin(); i != result_spell_list.end(); ++i )
-    {
-      if ( data_type == DATA_TALENT )
-      {
-        if ( ! sim -> dbc.talent( *i ) )
-          continue;
-
-        if ( ( sim -> dbc.talent( *i ) -> mask_class() & class_mask ) == 0 )
-          res.push_back( *i );
-      }
-      else
-      {
-        const spell_data_t* spell = sim -> dbc.spell( *i );
-        if ( ! spell )
-          continue;
+      return filter( TABLE_SPELL, SD_TYPE_UNSIGNED, O_SD( _class_mask ), op, mask );
+  }
 
-        if ( ( spell -> class_mask() & class_mask ) == 0 )
-          res.push_back( *i );
-      }
-    }
+  virtual std::vector<uint32_t> operator==( const spell_data_expr_t& other ) override
+  { return filter_class( other, SCAN_MASK_ANY ); }
 
-    return res;
-  }
+  virtual std::vector<uint32_t> operator!=( const spell_data_expr_t& other ) override
+  { return filter_class( other, SCAN_MASK_NONE ); }
 };
 
 struct spell_race_expr_t : public spell_list_expr_t
 {
   spell_race_expr_t( sim_t* sim, expr_data_e type ) : spell_list_expr_t( sim, "race", type ) { }
 
-  virtual std::vector<uint32_t> operator==( const spell_data_expr_t& other ) override
+  std::vector<uint32_t> filter_race( const spell_data_expr_t& other, sdata_scan_op_e op ) const
   {
-    std::vector<uint32_t> res;
-    uint32_t              race_mask;
-
     // Talents are not race specific
     if ( data_type == DATA_TALENT )
-      return res;
+      return std::vector<uint32_t>();
 
-    if ( other.result_tok == expression::TOK_STR )
-      race_mask = race_str_to_mask( other.result_str );
     // Other types will not be allowed, e.g. you cannot do race=list
-    else
-      return res;
-
-    for ( std::vector<uint32_t>::const_iterator i = result_spell_list.begin(); i != result_spell_list.end(); ++i )
-    {
-      const spell_data_t* spell = sim -> dbc.spell( *i );
+    if ( other.result_tok != expression::TOK_STR )
+      return std::vector<uint32_t>();
 
-      if ( ! spell )
-        continue;
-
-      if ( spell -> race_mask() & race_mask )
-        res.push_back( *i );
-    }
-
-    return res;
+    spell_data_expr_t mask( sim, other.name_str, race_str_to_mask( other.result_str ) );
+    return filter( TABLE_SPELL, SD_TYPE_UNSIGNED, O_SD( _race_mask ), op, mask );
   }
 
-  virtual std::vector<uint32_t> operator!=( const spell_data_expr_t& other ) override
-  {
-    std::vector<uint32_t> res;
-    uint32_t              class_mask;
-
-    // Talents are not race specific
-    if ( data_type == DATA_TALENT )
-      return res;
-
-    if ( other.result_tok == expression::TOK_STR )
-      class_mask = race_str_to_mask( other.result_str );
-    // Other types will not be allowed, e.g. you cannot do class=list
-    else
-      return res;
-
-    for ( std::vector<uint32_t>::const_iterator i = result_spell_list.begin(); i != result_spell_list.end(); ++i )
-    {
-      const spell_data_t* spell = sim -> dbc.spell( *i );
-      if ( ! spell )
-        continue;
-
-      if ( ( spell -> class_mask() & class_mask ) == 0 )
-        res.push_back( *i );
-    }
+  virtual std::vector<uint32_t> operator==( const spell_data_expr_t& other ) override
+  { return filter_race( other, SCAN_MASK_ANY ); }
 
-    return res;
-  }
+  virtual std::vector<uint32_t> operator!=( const spell_data_expr_t& other ) override
+  { return filter_race( other, SCAN_MASK_NONE ); }
 };
 
 struct spell_attribute_expr_t : public spell_list_expr_t
@@ -960,33 +1125,22 @@ struct spell_attribute_expr_t : public spell_list_expr_t
 
   virtual std::vector<uint32_t> operator==( const spell_data_expr_t& other ) override
   {
-    std::vector<uint32_t> res;
-
     // Only for spells
     if ( data_type == DATA_EFFECT || data_type == DATA_TALENT )
-      return res;
+      return std::vector<uint32_t>();
 
     // Numbered attributes only
     if ( other.result_tok != expression::TOK_NUM )
-      return res;
+      return std::vector<uint32_t>();
 
     uint32_t attridx = ( unsigned ) other.result_num / ( sizeof( unsigned ) * 8 );
     uint32_t flagidx = ( unsigned ) other.result_num % ( sizeof( unsigned ) * 8 );
 
     assert( attridx < NUM_SPELL_FLAGS && flagidx < 32 );
 
-    for ( std::vector<uint32_t>::const_iterator i = result_spell_list.begin(); i != result_spell_list.end(); ++i )
-    {
-      const spell_data_t* spell = sim -> dbc.spell( *i );
-
-      if ( ! spell )
-        continue;
-
-      if ( spell -> attribute( attridx ) & ( 1 << flagidx ) )
-        res.push_back( *i );
-    }
-
-    return res;
+    spell_data_expr_t mask( sim, other.name_str, static_cast<double>( 1U << flagidx ) );
+    return filter( TABLE_SPELL, SD_TYPE_UNSIGNED, O_SD( _attributes ) + attridx * sizeof( unsigned ),
+                   SCAN_MASK_ANY, mask );
   }
 };
 
@@ -994,55 +1148,21 @@ struct spell_school_expr_t : public spell_list_expr_t
 {
   spell_school_expr_t( sim_t* sim, expr_data_e type ) : spell_list_expr_t( sim, "school", type ) { }
 
-  virtual std::vector<uint32_t> operator==( const spell_data_expr_t& other ) override
+  std::vector<uint32_t> filter_school( const spell_data_expr_t& other, sdata_scan_op_e op ) const
   {
-    std::vector<uint32_t> res;
-    uint32_t              school_mask;
-
-    if ( other.result_tok == expression::TOK_STR )
-      school_mask = school_str_to_mask( other.result_str );
-    // Other types will not be allowed, e.g. you cannot do class=list
-    else
-      return res;
-
-    for ( std::vector<uint32_t>::const_iterator i = result_spell_list.begin(); i != result_spell_list.end(); ++i )
-    {
-      const spell_data_t* spell = sim -> dbc.spell( *i );
-
-      if ( ! spell )
-        continue;
-
-      if ( ( spell -> school_mask() & school_mask ) == school_mask )
-        res.push_back( *i );
-    }
-
-    return res;
-  }
-
-  virtual std::vector<uint32_t> operator!=( const spell_data_expr_t& other ) override
-  {
-    std::vector<uint32_t> res;
-    uint32_t              school_mask;
-
-    if ( other.result_tok == expression::TOK_STR )
-      school_mask = school_str_to_mask( other.result_str );
     // Other types will not be allowed, e.g. you cannot do school=list
-    else
-      return res;
+    if ( other.result_tok != expression::TOK_STR )
+      return std::vector<uint32_t>();
 
-    for ( std::vector<uint32_t>::const_iterator i = result_spell_list.begin(); i != result_spell_list.end(); ++i )
-    {
-      const spell_data_t* spell = sim -> dbc.spell( *i );
-
-      if ( ! spell )
-        continue;
+    spell_data_expr_t mask( sim, other.name_str, school_str_to_mask( other.result_str ) );
+    return filter( TABLE_SPELL, SD_TYPE_UNSIGNED, O_SD( _school ), op, mask );
+  }
 
-      if ( ( spell -> school_mask() & school_mask ) == 0 )
-        res.push_back( *i );
-    }
+  virtual std::vector<uint32_t> operator==( const spell_data_expr_t& other ) override
+  { return filter_school( other, SCAN_MASK_ALL ); }
 
-    return res;
-  }
+  virtual std::vector<uint32_t> operator!=( const spell_data_expr_t& other ) override
+  { return filter_school( other, SCAN_MASK_NONE ); }
 };
 
 spell_data_expr_t* build_expression_tree( sim_t* sim,
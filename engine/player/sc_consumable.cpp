@@ -170,8 +170,8 @@ struct mana_potion_t : public action_t
     if ( player -> potion_used )
       return false;
 
-    if ( ( player -> resources.max    [ RESOURCE_MANA ] -
-           player -> resources.current[ RESOURCE_MANA ] ) < trigger )
+    if ( ( player -> resources.max[ RESOURCE_MANA ] -
+           player -> resource_current( RESOURCE_MANA ) ) < trigger )
       return false;
 
     return action_t::ready();
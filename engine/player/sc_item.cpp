@@ -529,7 +529,7 @@ int item_t::stat_value( size_t idx ) const
   if ( idx >= sizeof_array( parsed.data.stat_val ) - 1 )
     return -1;
 
-  return item_database::scaled_stat( *this, player -> dbc, idx, item_level() );
+  return item_database::scaled_stats( *this, player -> dbc, item_level() )[ idx ];
 }
 
 // item_t::active ===========================================================
@@ -1477,13 +1477,14 @@ bool item_t::decode_stats()
     }
   }
 
+  auto stat_block = item_database::scaled_stats( *this, player -> dbc, item_level() );
   for ( size_t i = 0; i < sizeof_array( parsed.data.stat_val ); i++ )
   {
     stat_e s = stat( i );
     if ( s == STAT_NONE ) continue;
 
-    base_stats.add_stat( s, stat_value( i ) );
-    stats.add_stat( s, stat_value( i ) );
+    base_stats.add_stat( s, stat_block[ i ] );
+    stats.add_stat( s, stat_block[ i ] );
   }
 
   // Hardcoded armor value in stats, use the approximation coefficient to do
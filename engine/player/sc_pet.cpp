@@ -35,6 +35,7 @@ void pet_t::init_pet_t_()
 
   party = owner -> party;
   regen_type = owner -> regen_type;
+  dot_tick_scheduler.active = owner -> dot_tick_scheduler.active;
 
   // Inherit owner's dbc state
   dbc.ptr = owner -> dbc.ptr;
@@ -732,6 +732,7 @@ player_t::player_t( sim_t*             s,
   last_foreground_action( 0 ), prev_gcd_actions( 0 ),
 
   off_gcdactions(),
+  dot_tick_scheduler( this ),
   cast_delay_reaction( timespan_t::zero() ), cast_delay_occurred( timespan_t::zero() ),
   callbacks( s ),
   use_apl( "" ),
@@ -787,10 +788,14 @@ player_t::player_t( sim_t*             s,
   active_during_iteration( false ),
   _mastery( spelleffect_data_t::nil() ),
   cache( this ),
+  snapshot_version( 0 ),
+  variable_version( 0 ),
   regen_type( REGEN_STATIC ),
   last_regen( timespan_t::zero() ),
   regen_caches( CACHE_MAX ),
   dynamic_regen_pets( false ),
+  linear_regen( true ),
+  analytic_regen( false ),
   visited_apls_( 0 ),
   action_list_id_( 0 )
 {
@@ -999,6 +1004,8 @@ void player_t::init()
     }
   }
 
+  analytic_regen = sim -> analytic_regen && regen_type == REGEN_DYNAMIC && linear_regen;
+
   // If Single-actor batch mode is used, player_collected_data_t::fight_length has to be
   // unconditionally made to record full data on actor fight lengths. This is to get proper
   // information on timelines in reports, since the sim-wide fight lengths ar no longer usable as
@@ -1573,6 +1580,7 @@ void player_t::init_resources( bool force )
   }
 
   resources.current = resources.max = resources.initial;
+  resources.version++;
 
   // Only collect pet resource timelines if they get reported separately
   if ( ! is_pet() || sim -> report_pets_separately )
@@ -2495,7 +2503,7 @@ void player_t::init_assessors()
     proc_types pt = state -> proc_type();
     proc_types2 pt2 = state -> impact_proc_type2();
     if ( pt != PROC1_INVALID && pt2 != PROC2_INVALID )
-      action_callback_t::trigger( callbacks.procs[ pt ][ pt2 ], state -> action, state );
+      state -> action -> trigger_proc_callbacks( pt, pt2, state );
 
     return assessor::CONTINUE;
   } );
@@ -2507,6 +2515,9 @@ bool player_t::init_finished()
 {
   bool ret = true;
 
+  init_cache_dependencies();
+  cache.compile_dependencies();
+
   for ( auto action : action_list )
   {
     if ( ! action -> init_finished() )
@@ -3694,7 +3705,7 @@ double player_t::composite_player_vulnerability( school_e /* school */ ) const
 
   // 1% damage taken per stack, arbitrary because this buff is completely fabricated!
   if ( debuffs.damage_taken && debuffs.damage_taken -> check() )
-    m *= 1.0 + debuffs.damage_taken -> current_stack * 0.01;
+    m *= 1.0 + debuffs.damage_taken -> check() * 0.01;
 
   return m;
 }
@@ -3709,78 +3720,60 @@ double player_t::composite_mastery_value() const
   return composite_mastery() * mastery_coefficient();
 }
 
+// player_t::init_cache_dependencies ========================================
+
+void player_t::init_cache_dependencies()
+{
+  // Aggregate caches invalidate their attack and spell ( or damage, healing and mitigation )
+  // components, and haste changes the corresponding speed
+  static const std::pair<cache_e, cache_e> dependencies[] = {
+    { CACHE_EXP,          CACHE_ATTACK_EXP               },
+    { CACHE_EXP,          CACHE_SPELL_HIT                },
+    { CACHE_HIT,          CACHE_ATTACK_HIT               },
+    { CACHE_HIT,          CACHE_SPELL_HIT                },
+    { CACHE_CRIT_CHANCE,  CACHE_ATTACK_CRIT_CHANCE       },
+    { CACHE_CRIT_CHANCE,  CACHE_SPELL_CRIT_CHANCE        },
+    { CACHE_HASTE,        CACHE_ATTACK_HASTE             },
+    { CACHE_HASTE,        CACHE_SPELL_HASTE              },
+    { CACHE_SPEED,        CACHE_ATTACK_SPEED             },
+    { CACHE_SPEED,        CACHE_SPELL_SPEED              },
+    { CACHE_VERSATILITY,  CACHE_DAMAGE_VERSATILITY       },
+    { CACHE_VERSATILITY,  CACHE_HEAL_VERSATILITY         },
+    { CACHE_VERSATILITY,  CACHE_MITIGATION_VERSATILITY   },
+    { CACHE_ATTACK_HASTE, CACHE_ATTACK_SPEED             },
+    { CACHE_SPELL_HASTE,  CACHE_SPELL_SPEED              },
+    { CACHE_BONUS_ARMOR,  CACHE_ARMOR                    },
+  };
+
+  for ( const auto& dependency : dependencies )
+    cache.add_dependency( dependency.first, dependency.second );
+
+  // Attribute conversions of the actor. The conversion ratios are only set up on reset, and some
+  // modules change them at runtime ( e.g., druid forms ), so the links are always declared.
+  cache.add_dependency( CACHE_STRENGTH, CACHE_ATTACK_POWER );
+  cache.add_dependency( CACHE_STRENGTH, CACHE_PARRY );
+  cache.add_dependency( CACHE_AGILITY, CACHE_ATTACK_POWER );
+  cache.add_dependency( CACHE_AGILITY, CACHE_DODGE );
+  cache.add_dependency( CACHE_INTELLECT, CACHE_SPELL_POWER );
+}
+
 #if defined(SC_USE_STAT_CACHE)
 
 // player_t::invalidate_cache ===============================================
 
 void player_t::invalidate_cache( cache_e c )
 {
+  snapshot_version++;
+
   if ( ! cache.active ) return;
 
   if ( sim -> debug ) sim -> out_debug.printf( "%s invalidates %s", name(), util::cache_type_string( c ) );
 
-  // Special linked invalidations
-  switch ( c )
-  {
-    case CACHE_STRENGTH:
-      if ( current.attack_power_per_strength > 0 )
-        invalidate_cache( CACHE_ATTACK_POWER );
-      if ( current.parry_per_strength > 0 )
-        invalidate_cache( CACHE_PARRY );
-      break;
-    case CACHE_AGILITY:
-      if ( current.attack_power_per_agility > 0 )
-        invalidate_cache( CACHE_ATTACK_POWER );
-      if ( current.dodge_per_agility > 0 )
-        invalidate_cache( CACHE_DODGE );
-      break;
-    case CACHE_INTELLECT:
-      if ( current.spell_power_per_intellect > 0 )
-        invalidate_cache( CACHE_SPELL_POWER );
-      break;
-    case CACHE_ATTACK_HASTE:
-      invalidate_cache( CACHE_ATTACK_SPEED );
-      break;
-    case CACHE_SPELL_HASTE:
-      invalidate_cache( CACHE_SPELL_SPEED );
-      break;
-    case CACHE_BONUS_ARMOR:
-      invalidate_cache( CACHE_ARMOR );
-    default: break;
-  }
-
-  // Normal invalidation of the corresponding Cache
-  switch ( c )
-  {
-    case CACHE_EXP:
-      invalidate_cache( CACHE_ATTACK_EXP );
-      invalidate_cache( CACHE_SPELL_HIT  );
-      break;
-    case CACHE_HIT:
-      invalidate_cache( CACHE_ATTACK_HIT );
-      invalidate_cache( CACHE_SPELL_HIT  );
-      break;
-    case CACHE_CRIT_CHANCE:
-      invalidate_cache( CACHE_ATTACK_CRIT_CHANCE );
-      invalidate_cache( CACHE_SPELL_CRIT_CHANCE  );
-      break;
-    case CACHE_HASTE:
-      invalidate_cache( CACHE_ATTACK_HASTE );
-      invalidate_cache( CACHE_SPELL_HASTE  );
-      break;
-    case CACHE_SPEED:
-      invalidate_cache( CACHE_ATTACK_SPEED );
-      invalidate_cache( CACHE_SPELL_SPEED  );
-      break;
-    case CACHE_VERSATILITY:
-      invalidate_cache( CACHE_DAMAGE_VERSATILITY );
-      invalidate_cache( CACHE_HEAL_VERSATILITY );
-      invalidate_cache( CACHE_MITIGATION_VERSATILITY );
-      break;
-    default:
-      cache.invalidate( c );
-      break;
-  }
+  // Until the dependencies are compiled at the end of initialization, invalidate everything
+  if ( cache.compiled )
+    cache.invalidate( cache.invalidation_mask[ c ] );
+  else
+    cache.invalidate_all();
 }
 
 #endif
@@ -4178,6 +4171,9 @@ void player_t::merge( player_t& other )
 {
   collected_data.merge( other.collected_data );
 
+  callbacks.filtered_visits += other.callbacks.filtered_visits;
+  callbacks.filtered_skips += other.callbacks.filtered_skips;
+
   for ( resource_e i = RESOURCE_NONE; i < RESOURCE_MAX; ++i )
   {
     iteration_resource_lost  [ i ] += other.iteration_resource_lost  [ i ];
@@ -4283,6 +4279,7 @@ void player_t::merge( player_t& other )
     if ( action_list[ i ] -> internal_id == other.action_list[ i ] -> internal_id )
     {
       action_list[ i ] -> total_executions += other.action_list[ i ] -> total_executions;
+      action_list[ i ] -> apl_profile.merge( other.action_list[ i ] -> apl_profile );
     }
     else
     {
@@ -4321,8 +4318,7 @@ void player_t::reset()
     sim -> out_debug.printf( "%s current stats ( reset to initial ): %s", name(), current.to_string().c_str() );
   }
 
-  for ( size_t i = 0; i < buff_list.size(); ++i )
-    buff_list[ i ] -> reset();
+  reset_touched( *sim, buff_list, touched_buffs );
 
   last_foreground_action = 0;
   prev_gcd_actions.clear();
@@ -4334,6 +4330,7 @@ void player_t::reset()
   queueing = nullptr;
   channeling = nullptr;
   readying = nullptr;
+  dot_tick_scheduler.reset();
   strict_sequence = 0;
   off_gcd = 0;
   in_combat = false;
@@ -4353,8 +4350,7 @@ void player_t::reset()
   off_hand_weapon.buff_value = 0;
   off_hand_weapon.bonus_dmg  = 0;
 
-  x_position = default_x_position;
-  y_position = default_y_position;
+  set_position( default_x_position, default_y_position );
 
   callbacks.reset();
 
@@ -4363,11 +4359,58 @@ void player_t::reset()
   for ( size_t i = 0; i < action_list.size(); ++i )
     action_list[ i ] -> reset();
 
+  // With all expressions of the actor optimized, share subexpressions that occur in several action
+  // list lines, cache subexpressions whose inputs are known, and flatten the expression trees for
+  // faster evaluation
+  if ( sim -> current_iteration == 1 )
+  {
+    std::vector<std::pair<action_t*, expr_t**>> exprs;
+    std::vector<expr_t**> action_exprs;
+    for ( action_t* a : action_list )
+    {
+      action_exprs.clear();
+      a -> collect_expressions( action_exprs );
+      for ( expr_t** e : action_exprs )
+        exprs.push_back( std::make_pair( a, e ) );
+    }
+
+    if ( sim -> share_expressions )
+    {
+      for ( const auto& e : exprs )
+        expr_t::count_shared( *e.second );
+
+      for ( const auto& e : exprs )
+        *e.second = expr_t::share( e.first, *e.second );
+    }
+
+    for ( const auto& e : exprs )
+      *e.second = expr_t::cache( e.first, *e.second );
+
+    for ( const auto& e : exprs )
+      *e.second = expr_t::compile( e.first, *e.second );
+  }
+
+  if ( sim -> share_expressions && sim -> current_iteration == 1 && ! sim -> parent )
+  {
+    unsigned n_shared = 0, n_deduplicated = 0;
+    for ( const auto& entry : shared_expressions )
+    {
+      if ( entry.second -> kept > 1 )
+      {
+        n_shared++;
+        n_deduplicated += entry.second -> kept - 1;
+      }
+    }
+
+    if ( n_shared > 0 )
+      sim -> out_std.printf( "Player %s: Shared %u expression subtrees, deduplicated %u nodes.",
+                             name(), n_shared, n_deduplicated );
+  }
+
   for ( size_t i = 0; i < cooldown_list.size(); ++i )
     cooldown_list[ i ] -> reset_init();
 
-  for ( size_t i = 0; i < dot_list.size(); ++i )
-    dot_list[ i ] -> reset();
+  reset_touched( *sim, dot_list, touched_dots );
 
   for ( size_t i = 0; i < stats_list.size(); ++i )
     stats_list[ i ] -> reset();
@@ -4789,13 +4832,16 @@ action_t* player_t::execute_action()
 
   action_t* action = 0;
 
-  if ( regen_type == REGEN_DYNAMIC )
+  if ( regen_type == REGEN_DYNAMIC && ! analytic_regen )
     do_dynamic_regen();
 
   if ( ! strict_sequence )
   {
     visited_apls_ = 0; // Reset visited apl list
+    lazy_variables.active = sim -> lazy_variables;
     action = select_action( *active_action_list );
+    if ( lazy_variables.active )
+      end_lazy_variable_pass();
   }
   // Committed to a strict sequence of actions, just perform them instead of a priority list
   else
@@ -4837,7 +4883,7 @@ void player_t::regen( timespan_t periodicity )
 {
   if ( regen_type == REGEN_DYNAMIC && sim -> debug )
     sim -> out_debug.printf( "%s dynamic regen, last=%.3f interval=%.3f",
-        name(), last_regen.total_seconds(), periodicity.total_seconds() );
+        name(), ( last_regen - periodicity ).total_seconds(), periodicity.total_seconds() );
 
   for ( resource_e r = RESOURCE_HEALTH; r < RESOURCE_MAX; r++ )
   {
@@ -4873,6 +4919,26 @@ void player_t::regen( timespan_t periodicity )
   }
 }
 
+// player_t::resource_regen_per_second ======================================
+
+double player_t::resource_regen_per_second( resource_e r ) const
+{
+  if ( ! resources.is_active( r ) )
+    return 0;
+
+  switch ( r )
+  {
+    case RESOURCE_ENERGY:
+      return energy_regen_per_second();
+    case RESOURCE_FOCUS:
+      return focus_regen_per_second();
+    case RESOURCE_MANA:
+      return mana_regen_per_second();
+    default:
+      return 0;
+  }
+}
+
 // player_t::collect_resource_timeline_information ==========================
 
 void player_t::collect_resource_timeline_information()
@@ -4880,7 +4946,7 @@ void player_t::collect_resource_timeline_information()
   for (auto & elem : collected_data.resource_timelines)
   {
     elem.timeline.add( sim -> current_time(),
-        resources.current[ elem.type ] );
+        resource_current( elem.type ) );
   }
 
   for (auto & elem : collected_data.stat_timelines)
@@ -4922,6 +4988,10 @@ double player_t::resource_loss( resource_e resource_type,
   if ( current.sleeping )
     return 0.0;
 
+  // Bring analytically regenerating resources up to date before changing them
+  if ( analytic_regen )
+    do_dynamic_regen();
+
   if ( resource_type == primary_resource() )
     uptimes.primary_resource_cap -> update( false, sim -> current_time() );
 
@@ -4939,6 +5009,7 @@ double player_t::resource_loss( resource_e resource_type,
     resources.current[ resource_type ] -= actual_amount;
     iteration_resource_lost[ resource_type ] += actual_amount;
   }
+  resources.version++;
 
   if ( source )
   {
@@ -4973,12 +5044,16 @@ double player_t::resource_gain( resource_e resource_type,
   if ( current.sleeping || amount == 0.0 )
     return 0.0;
 
+  if ( analytic_regen )
+    do_dynamic_regen();
+
   double actual_amount = std::min( amount, resources.max[ resource_type ] - resources.current[ resource_type ] );
 
   if ( actual_amount > 0.0 )
   {
     resources.current[ resource_type ] += actual_amount;
     iteration_resource_gained [ resource_type ] += actual_amount;
+    resources.version++;
   }
 
   if ( resource_type == primary_resource() && resources.max[ resource_type ] <= resources.current[ resource_type ] )
@@ -5011,7 +5086,7 @@ bool player_t::resource_available( resource_e resource_type,
     return true;
   }
 
-  bool available = resources.current[ resource_type ] >= cost;
+  bool available = resource_current( resource_type ) >= cost;
 
 #ifndef NDEBUG
   if ( ! resources.active_resource[ resource_type ] )
@@ -5027,6 +5102,11 @@ bool player_t::resource_available( resource_e resource_type,
 
 void player_t::recalculate_resource_max( resource_e resource_type )
 {
+  // Regeneration up to now is capped by the old maximum
+  if ( analytic_regen )
+    do_dynamic_regen();
+
+  resources.version++;
   resources.max[ resource_type ]  = resources.base[ resource_type ];
   resources.max[ resource_type ] *= resources.base_multiplier[ resource_type ];
   resources.max[ resource_type ] += total_gear.resource[ resource_type ];
@@ -5980,14 +6060,9 @@ bool player_t::recent_cast()
 dot_t* player_t::find_dot( const std::string& name,
                            player_t* source ) const
 {
-  for ( size_t i = 0; i < dot_list.size(); ++i )
-  {
-    dot_t* d = dot_list[ i ];
-    if ( d -> source == source &&
-         d -> name_str == name )
-      return d;
-  }
-  return 0;
+  return name_index.dot.find( dot_list, name, [ source ]( const dot_t* d ) {
+    return d -> source == source;
+  } );
 }
 
 // player_t::clear_action_priority_lists() ==================================
@@ -6041,28 +6116,28 @@ pet_t* player_t::find_pet( const std::string& name ) const
 { return find_vector_member( pet_list, name ); }
 
 stats_t* player_t::find_stats( const std::string& name ) const
-{ return find_vector_member( stats_list, name ); }
+{ return name_index.stats.find( stats_list, name ); }
 
 gain_t* player_t::find_gain ( const std::string& name ) const
-{ return find_vector_member( gain_list, name ); }
+{ return name_index.gain.find( gain_list, name ); }
 
 proc_t* player_t::find_proc ( const std::string& name ) const
-{ return find_vector_member( proc_list, name ); }
+{ return name_index.proc.find( proc_list, name ); }
 
 luxurious_sample_data_t* player_t::find_sample_data( const std::string& name ) const
-{ return find_vector_member( sample_data_list, name ); }
+{ return name_index.sample_data.find( sample_data_list, name ); }
 
 benefit_t* player_t::find_benefit ( const std::string& name ) const
-{ return find_vector_member( benefit_list, name ); }
+{ return name_index.benefit.find( benefit_list, name ); }
 
 uptime_t* player_t::find_uptime ( const std::string& name ) const
-{ return find_vector_member( uptime_list, name ); }
+{ return name_index.uptime.find( uptime_list, name ); }
 
 cooldown_t* player_t::find_cooldown( const std::string& name ) const
-{ return find_vector_member( cooldown_list, name ); }
+{ return name_index.cooldown.find( cooldown_list, name ); }
 
 action_t* player_t::find_action( const std::string& name ) const
-{ return find_vector_member( action_list, name ); }
+{ return name_index.action.find( action_list, name ); }
 
 // player_t::get_cooldown ===================================================
 
@@ -6354,6 +6429,8 @@ struct stop_moving_t : public action_t
   }
 };
 
+bool is_pass_scoped_variable( const player_t&, const action_variable_t& );
+
 struct variable_t : public action_t
 {
   action_var_e operation;
@@ -6509,6 +6586,28 @@ struct variable_t : public action_t
     return ret;
   }
 
+  void reset() override
+  {
+    action_t::reset();
+
+    if ( sim -> current_iteration == 1 )
+    {
+      if ( sim -> lazy_variables )
+      {
+        var -> pass_scoped = is_pass_scoped_variable( *player, *var );
+      }
+    }
+  }
+
+  void collect_expressions( std::vector<expr_t**>& exprs ) override
+  {
+    action_t::collect_expressions( exprs );
+
+    exprs.push_back( &value_expression );
+    exprs.push_back( &condition_expression );
+    exprs.push_back( &value_else_expression );
+  }
+
   ~variable_t()
   {
     delete value_expression;
@@ -6516,95 +6615,292 @@ struct variable_t : public action_t
     delete value_else_expression;
   }
 
-  // Note note note, doesn't do anything that a real action does
-  void execute() override
+  // Operations that do not depend on the prior value of the variable
+  bool is_set_operation() const
   {
-    if ( sim -> debug && operation != OPERATION_PRINT )
-    {
-      sim -> out_debug.printf( "%s variable name=%s op=%d value=%f default=%f sig=%s",
-        player -> name(), var -> name_.c_str(), operation, var -> current_value_, var -> default_, signature_str.c_str() );
-    }
+    return operation == OPERATION_SET || operation == OPERATION_SETIF || operation == OPERATION_RESET;
+  }
 
+  // Apply the operation to the given value of the variable, returning the new value
+  double apply( double value )
+  {
     switch ( operation )
     {
       case OPERATION_SET:
-        var -> current_value_ = value_expression -> eval();
-        break;
+        return value_expression -> eval();
       case OPERATION_ADD:
-        var -> current_value_ += value_expression -> eval();
-        break;
+        return value + value_expression -> eval();
       case OPERATION_SUB:
-        var -> current_value_ -= value_expression -> eval();
-        break;
+        return value - value_expression -> eval();
       case OPERATION_MUL:
-        var -> current_value_ *= value_expression -> eval();
-        break;
+        return value * value_expression -> eval();
       case OPERATION_DIV:
       {
         auto v = value_expression -> eval();
         // Disallow division by zero, set value to zero
-        if ( v == 0 )
-        {
-          var -> current_value_ = 0;
-        }
-        else
-        {
-          var -> current_value_ /= v;
-        }
-        break;
+        return v == 0 ? 0 : value / v;
       }
       case OPERATION_POW:
-        var -> current_value_ = std::pow( var -> current_value_, value_expression -> eval() );
-        break;
+        return std::pow( value, value_expression -> eval() );
       case OPERATION_MOD:
       {
         // Disallow division by zero, set value to zero
         auto v = value_expression -> eval();
-        if ( v == 0 )
-        {
-          var -> current_value_ = 0;
-        }
-        else
-        {
-          var -> current_value_ = std::fmod( var -> current_value_, value_expression -> eval() );
-        }
-        break;
+        return v == 0 ? 0 : std::fmod( value, v );
       }
       case OPERATION_MIN:
-        var -> current_value_ = std::min( var -> current_value_, value_expression -> eval() );
-        break;
+        return std::min( value, value_expression -> eval() );
       case OPERATION_MAX:
-        var -> current_value_ = std::max( var -> current_value_, value_expression -> eval() );
-        break;
+        return std::max( value, value_expression -> eval() );
       case OPERATION_FLOOR:
-        var -> current_value_ = util::floor( var -> current_value_ );
-        break;
+        return util::floor( value );
       case OPERATION_CEIL:
-        var -> current_value_ = util::ceil( var -> current_value_ );
-        break;
-      case OPERATION_PRINT:
-        // Only spit out prints in main thread
-        if ( sim -> parent == 0 )
-          std::cout << "actor=" << player -> name_str << " time=" << sim -> current_time().total_seconds()
-            << " iteration=" << sim -> current_iteration << " variable=" << var -> name_.c_str()
-            << " value=" << var -> current_value_ << std::endl;
-        break;
+        return util::ceil( value );
       case OPERATION_RESET:
-        var -> reset();
-        break;
+        return var -> default_;
       case OPERATION_SETIF:
         if ( condition_expression->eval() != 0 )
-          var->current_value_ = value_expression->eval();
+          return value_expression->eval();
         else
-          var->current_value_ = value_else_expression->eval();
-        break;
+          return value_else_expression->eval();
       default:
         assert( 0 );
-        break;
+        return value;
+    }
+  }
+
+  // Note note note, doesn't do anything that a real action does
+  void execute() override
+  {
+    if ( sim -> debug && operation != OPERATION_PRINT )
+    {
+      sim -> out_debug.printf( "%s variable name=%s op=%d value=%f default=%f sig=%s",
+        player -> name(), var -> name_.c_str(), operation, var -> current_value_, var -> default_, signature_str.c_str() );
+    }
+
+    if ( operation == OPERATION_PRINT )
+    {
+      // Only spit out prints in main thread
+      if ( sim -> parent == 0 )
+        std::cout << "actor=" << player -> name_str << " time=" << sim -> current_time().total_seconds()
+          << " iteration=" << sim -> current_iteration << " variable=" << var -> name_.c_str()
+          << " value=" << player -> variable_value( var ) << std::endl;
+      return;
+    }
+
+    // Lazy evaluation, queue the operation to be evaluated when the variable is read. Change the
+    // actor variable version, as the value of the variable may change.
+    if ( player -> lazy_variables.active )
+    {
+      if ( var -> lazy_ops.empty() )
+      {
+        var -> lazy_base_value = var -> current_value_;
+        player -> lazy_variables.touched.push_back( var );
+      }
+
+      action_variable_t::lazy_op_t op = { ++player -> lazy_variables.seq, this, 0, false };
+      var -> lazy_ops.push_back( op );
+      player -> variable_version++;
+      return;
+    }
+
+    double old_value = var -> current_value_;
+
+    var -> current_value_ = apply( var -> current_value_ );
+
+    if ( var -> current_value_ != old_value )
+    {
+      var -> version++;
+      player -> variable_version++;
     }
   }
 };
 
+// Lazy variable evaluation =================================================
+
+// Return true if an expression of the action reads the variable
+bool action_reads_variable( const action_t& a, const action_variable_t& var )
+{
+  return range::find( a.variable_reads, &var ) != a.variable_reads.end();
+}
+
+// Return true if the line at position idx of the list reads the variable. Lines that reference
+// other actions (action.X, sync=) may evaluate arbitrary lines, and a pool_resource line evaluates
+// the line following it, so they are considered to read the variable as well.
+bool line_reads_variable( const action_priority_list_t& list, size_t idx, const action_variable_t& var )
+{
+  const action_t* a = list.foreground_action_list[ idx ];
+  if ( action_reads_variable( *a, var ) )
+    return true;
+
+  std::string sig = a -> signature_str;
+  util::tolower( sig );
+  if ( sig.find( "action." ) != std::string::npos || sig.find( "sync=" ) != std::string::npos )
+    return true;
+
+  if ( util::str_compare_ci( a -> name_str, "pool_resource" ) && idx + 1 < list.foreground_action_list.size() )
+  {
+    return line_reads_variable( list, idx + 1, var );
+  }
+
+  return false;
+}
+
+// Return true if the list, or any list it calls, reads or modifies the variable
+bool list_reads_variable( const action_priority_list_t& list, const action_variable_t& var,
+                          uint64_t visited )
+{
+  if ( visited & list.internal_id_mask )
+    return false;
+
+  visited |= list.internal_id_mask;
+
+  for ( size_t i = 0; i < list.foreground_action_list.size(); ++i )
+  {
+    const action_t* a = list.foreground_action_list[ i ];
+    if ( line_reads_variable( list, i, var ) )
+      return true;
+
+    if ( a -> type == ACTION_VARIABLE && debug_cast<const variable_t*>( a ) -> var == &var )
+      return true;
+
+    if ( a -> type == ACTION_CALL &&
+         list_reads_variable( *static_cast<const call_action_list_t*>( a ) -> alist, var, visited ) )
+      return true;
+  }
+
+  return false;
+}
+
+// Determine if every read of the variable in an APL pass is preceded by an unconditional set of
+// it, and no read can happen after the pass. The analysis is done per action list a pass can start
+// from, and is conservative: any construct that can evaluate action list lines outside of a pass
+// (off gcd lists, channel interruption and chaining, sequences, pet actions queried by the owner)
+// disables it for the actor. The line selected by the pass may evaluate its expressions after the
+// pass has ended (e.g., wait,sec=), so any selectable line reading the variable after the set
+// disables it as well.
+bool is_pass_scoped_variable( const player_t& p, const action_variable_t& var )
+{
+  if ( p.is_pet() )
+    return false;
+
+  for ( const action_t* a : p.action_list )
+  {
+    if ( a -> type == ACTION_SEQUENCE )
+      return false;
+
+    if ( a -> channeled && ( a -> option.interrupt || a -> option.chain || a -> option.interrupt_immediate ||
+                             a -> interrupt_if_expr || a -> early_chain_if_expr ) )
+      return false;
+  }
+
+  // Other actors can read the variable through owner/pet expressions at any time
+  for ( const player_t* actor : p.sim -> actor_list )
+  {
+    if ( actor == &p )
+      continue;
+
+    for ( const action_t* a : actor -> action_list )
+    {
+      if ( action_reads_variable( *a, var ) )
+        return false;
+    }
+  }
+
+  for ( const action_priority_list_t* list : p.action_priority_list )
+  {
+    if ( list -> random || ! list -> off_gcd_actions.empty() )
+      return false;
+
+    if ( list -> name_str == "precombat" )
+      continue;
+
+    bool set = false;
+    for ( size_t i = 0; i < list -> foreground_action_list.size(); ++i )
+    {
+      const action_t* a = list -> foreground_action_list[ i ];
+      if ( a -> background )
+        continue;
+
+      // After the set, only reads by lines that are evaluated within the pass are allowed. Lines
+      // called after the set are checked by the scan of their own list.
+      if ( set )
+      {
+        if ( a -> type != ACTION_VARIABLE && a -> type != ACTION_CALL &&
+             line_reads_variable( *list, i, var ) )
+          return false;
+
+        continue;
+      }
+
+      if ( line_reads_variable( *list, i, var ) )
+        return false;
+
+      // Any other operation on the variable before the unconditional set reads its prior value
+      if ( a -> type == ACTION_VARIABLE && debug_cast<const variable_t*>( a ) -> var == &var )
+      {
+        const variable_t* v = debug_cast<const variable_t*>( a );
+        if ( v -> is_set_operation() && ! v -> if_expr && ! v -> sync_action &&
+             v -> cooldown -> duration == timespan_t::zero() &&
+             v -> line_cooldown.duration == timespan_t::zero() && v -> option.moving == -1 )
+        {
+          set = true;
+          continue;
+        }
+
+        return false;
+      }
+
+      if ( a -> type == ACTION_CALL &&
+           list_reads_variable( *static_cast<const call_action_list_t*>( a ) -> alist, var, 0 ) )
+        return false;
+    }
+  }
+
+  return true;
+}
+
+double lazy_variable_value( player_t& p, action_variable_t& var, uint64_t horizon );
+
+// Evaluate the queued operation at position idx. Reads of other variables during the evaluation
+// see their value as of the position of the operation in the APL pass.
+double lazy_variable_op_value( player_t& p, action_variable_t& var, size_t idx )
+{
+  if ( var.lazy_ops[ idx ].evaluated )
+    return var.lazy_ops[ idx ].value;
+
+  variable_t* action = debug_cast<variable_t*>( var.lazy_ops[ idx ].action );
+
+  double value = 0;
+  if ( ! action -> is_set_operation() )
+  {
+    value = idx == 0 ? var.lazy_base_value : lazy_variable_op_value( p, var, idx - 1 );
+  }
+
+  uint64_t horizon = p.lazy_variables.horizon;
+  p.lazy_variables.horizon = var.lazy_ops[ idx ].seq;
+  value = action -> apply( value );
+  p.lazy_variables.horizon = horizon;
+
+  var.lazy_ops[ idx ].value = value;
+  var.lazy_ops[ idx ].evaluated = true;
+
+  return value;
+}
+
+// Value of the variable as of the given position in the APL pass
+double lazy_variable_value( player_t& p, action_variable_t& var, uint64_t horizon )
+{
+  size_t n = var.lazy_ops.size();
+  while ( n > 0 && var.lazy_ops[ n - 1 ].seq >= horizon )
+    --n;
+
+  if ( n == 0 )
+    return var.lazy_base_value;
+
+  return lazy_variable_op_value( p, var, n - 1 );
+}
+
 // ===== Racial Abilities ===================================================
 
 struct racial_spell_t : public spell_t
@@ -6867,7 +7163,7 @@ struct restore_mana_t : public action_t
 
   virtual void execute() override
   {
-    double mana_missing = player -> resources.max[ RESOURCE_MANA ] - player -> resources.current[ RESOURCE_MANA ];
+    double mana_missing = player -> resources.max[ RESOURCE_MANA ] - player -> resource_current( RESOURCE_MANA );
     double mana_gain = mana;
 
     if ( mana_gain == 0 || mana_gain > mana_missing ) mana_gain = mana_missing;
@@ -7824,11 +8120,18 @@ struct pool_resource_t : public action_t
       // then this command will pool energy until we have enough.
 
       double theoretical_cost = next_action -> cost() + ( amount_expr ? amount_expr -> eval() : 0 );
+
+      // Lazily evaluated variable operations must see the real resources
+      if ( player -> lazy_variables.active )
+        player -> resolve_lazy_variables();
+
       player -> resources.current[ resource ] += theoretical_cost;
+      player -> resources.version++;
 
       bool resource_limited = next_action -> ready();
 
       player -> resources.current[ resource ] -= theoretical_cost;
+      player -> resources.version++;
 
       if ( ! resource_limited )
         return false;
@@ -9121,7 +9424,7 @@ expr_t* player_t::create_expression( action_t* a,
     struct variable_expr_t : public expr_t
     {
       player_t* player_;
-      const action_variable_t* var_;
+      action_variable_t* var_;
 
       variable_expr_t( player_t* p, const std::string& name ) :
         expr_t( "variable" ), player_( p ), var_( 0 )
@@ -9137,7 +9440,17 @@ expr_t* player_t::create_expression( action_t* a,
       }
 
       double evaluate() override
-      { return var_ -> current_value_; }
+      { return var_ -> lazy_ops.empty() ? var_ -> current_value_ : player_ -> variable_value( var_ ); }
+
+      bool dependencies( expr_deps_t& deps ) const override
+      {
+        // Lazily evaluated variables change value without their version changing
+        if ( player_ -> sim -> lazy_variables )
+          return false;
+
+        deps.versions.push_back( &var_ -> version );
+        return true;
+      }
     };
 
     variable_expr_t* expr = new variable_expr_t( this, splits[ 1 ] );
@@ -9147,7 +9460,11 @@ expr_t* player_t::create_expression( action_t* a,
       delete expr;
     }
     else
+    {
+      if ( a )
+        a -> variable_reads.push_back( expr -> var_ );
       return expr;
+    }
   }
 
   // trinkets
@@ -9414,7 +9731,7 @@ expr_t* player_t::create_expression( action_t* a,
     if ( splits[ 0 ] == "buff" || splits[ 0 ] == "debuff" )
     {
       a -> player -> get_target_data( this );
-      buff_t* buff = buff_t::find_expressable( buff_list, splits[ 1 ], a -> player );
+      buff_t* buff = buff_t::find_expressable( this, splits[ 1 ], a -> player );
       if ( ! buff ) buff = buff_t::find( this, splits[ 1 ], this ); // Raid debuffs
       if ( buff ) return buff_t::create_expression( splits[ 1 ], a, splits[ 2 ], buff );
     }
@@ -9458,14 +9775,7 @@ expr_t* player_t::create_expression( action_t* a,
 
     if ( splits[ 0 ] == "spell" && splits[ 2 ] == "exists" )
     {
-      struct spell_exists_expr_t : public expr_t
-      {
-        const std::string name;
-        player_t& player;
-        spell_exists_expr_t( const std::string& n, player_t& p ) : expr_t( n ), name( n ), player( p ) {}
-        virtual double evaluate() override { return player.find_spell( name ) -> ok(); }
-      };
-      return new spell_exists_expr_t( splits[ 1 ], *this );
+      return expr_t::create_constant( splits[ 1 ], find_spell( splits[ 1 ] ) -> ok() ? 1.0 : 0.0 );
     }
   }
   else if ( splits.size() == 2 )
@@ -9542,34 +9852,17 @@ expr_t* player_t::create_expression( action_t* a,
     }
   }
 
+  // Talents are fixed for the duration of the simulation, so the expression is always a constant
   if ( ( splits.size() == 3 ) && splits[ 0 ] == "talent" )
   {
-    struct s_expr_t : public player_expr_t
-    {
-      spell_data_t* s;
-
-      s_expr_t( const std::string& name, player_t& p, spell_data_t* sp ) :
-        player_expr_t( name, p ), s( sp ) {}
-      virtual double evaluate() override
-      { return ( s && s -> ok() ); }
-    };
-
     if ( splits[ 2 ] != "enabled" )
     {
       return 0;
     }
 
-    spell_data_t* s = nullptr;
-
-    if ( splits[ 0 ] == "talent" )
-    {
-      s = const_cast< spell_data_t* >( find_talent_spell( splits[ 1 ], specialization(), true ) );
-    }
+    const spell_data_t* s = find_talent_spell( splits[ 1 ], specialization(), true );
 
-    if( sim -> optimize_expressions )
-      return expr_t::create_constant( expression_str, ( s && s -> ok() ) ? 1.0 : 0.0 );
-    else
-      return new s_expr_t( expression_str, *this, s );
+    return expr_t::create_constant( expression_str, ( s && s -> ok() ) ? 1.0 : 0.0 );
   }
   else if ( splits.size() == 3 && splits[ 0 ] == "artifact" && ( splits[ 2 ] == "enabled" || splits[ 2 ] == "rank" ) )
   {
@@ -9671,7 +9964,16 @@ expr_t* player_t::create_resource_expression( const std::string& name_str )
     return 0;
 
   if ( splits.size() == 1 )
-    return make_ref_expr( name_str, resources.current[ r ] );
+  {
+    if ( sim -> analytic_regen && regen_type == REGEN_DYNAMIC )
+    {
+      return make_dependent_expr( *sim, make_fn_expr( name_str, [ this, r ] { return resource_current( r ); } ),
+                                  { &resources.version }, true );
+    }
+
+    return make_dependent_expr( *sim, make_ref_expr( name_str, resources.current[ r ] ),
+                                { &resources.version }, true );
+  }
 
   if ( splits.size() == 2 )
   {
@@ -9682,7 +9984,13 @@ expr_t* player_t::create_resource_expression( const std::string& name_str )
         resource_deficit_expr_t( const std::string& n, player_t& p, resource_e r ) :
           resource_expr_t( n, p, r ) {}
         virtual double evaluate() override
-        { return player.resources.max[ rt ] - player.resources.current[ rt ]; }
+        { return player.resources.max[ rt ] - player.resource_current( rt ); }
+        bool dependencies( expr_deps_t& deps ) const override
+        {
+          deps.versions.push_back( &player.resources.version );
+          deps.time = true;
+          return true;
+        }
       };
       return new resource_deficit_expr_t( name_str, *this, r );
     }
@@ -9691,7 +9999,8 @@ expr_t* player_t::create_resource_expression( const std::string& name_str )
     {
       if ( r == RESOURCE_HEALTH )
       {
-        return make_mem_fn_expr( name_str, *this, &player_t::health_percentage );
+        return make_dependent_expr( *sim, make_mem_fn_expr( name_str, *this, &player_t::health_percentage ),
+                                    { &resources.version }, true );
       }
       else
       {
@@ -9700,14 +10009,21 @@ expr_t* player_t::create_resource_expression( const std::string& name_str )
           resource_pct_expr_t( const std::string& n, player_t& p, resource_e r  ) :
             resource_expr_t( n, p, r ) {}
           virtual double evaluate() override
-          { return player.resources.pct( rt ) * 100.0; }
+          { return player.resource_current( rt ) / player.resources.max[ rt ] * 100.0; }
+          bool dependencies( expr_deps_t& deps ) const override
+          {
+            deps.versions.push_back( &player.resources.version );
+            deps.time = true;
+            return true;
+          }
         };
         return new resource_pct_expr_t( name_str, *this, r  );
       }
     }
 
     else if ( splits[ 1 ] == "max" )
-      return make_ref_expr( name_str, resources.max[ r ] );
+      return make_dependent_expr( *sim, make_ref_expr( name_str, resources.max[ r ] ),
+                                  { &resources.version }, true );
 
     else if ( splits[ 1 ] == "max_nonproc" )
       return make_ref_expr( name_str, collected_data.buffed_stats_snapshot.resource[ r ] );
@@ -9719,7 +10035,7 @@ expr_t* player_t::create_resource_expression( const std::string& name_str )
         resource_pct_nonproc_expr_t( const std::string& n, player_t& p, resource_e r ) :
           resource_expr_t( n, p, r ) {}
         virtual double evaluate() override
-        { return player.resources.current[ rt ] / player.collected_data.buffed_stats_snapshot.resource[ rt ] * 100.0; }
+        { return player.resource_current( rt ) / player.collected_data.buffed_stats_snapshot.resource[ rt ] * 100.0; }
       };
       return new resource_pct_nonproc_expr_t( name_str, *this, r );
     }
@@ -9763,7 +10079,7 @@ expr_t* player_t::create_resource_expression( const std::string& name_str )
           virtual double evaluate() override
           {
             return ( player.resources.max[RESOURCE_ENERGY] -
-              player.resources.current[RESOURCE_ENERGY] ) /
+              player.resource_current( RESOURCE_ENERGY ) ) /
               player.energy_regen_per_second();
           }
         };
@@ -9780,7 +10096,7 @@ expr_t* player_t::create_resource_expression( const std::string& name_str )
           virtual double evaluate() override
           {
             return ( player.resources.max[RESOURCE_FOCUS] -
-              player.resources.current[RESOURCE_FOCUS] ) /
+              player.resource_current( RESOURCE_FOCUS ) ) /
               player.focus_regen_per_second();
           }
         };
@@ -9797,7 +10113,7 @@ expr_t* player_t::create_resource_expression( const std::string& name_str )
           virtual double evaluate() override
           {
             return ( player.resources.max[RESOURCE_MANA] -
-              player.resources.current[RESOURCE_MANA] ) /
+              player.resource_current( RESOURCE_MANA ) ) /
               player.mana_regen_per_second();
           }
         };
@@ -10401,6 +10717,7 @@ void player_t::create_options()
     add_option( opt_timespan( "reaction_time_nu", reaction_nu ) );
     add_option( opt_timespan( "reaction_time_offset", reaction_offset ) );
     add_option( opt_bool( "stat_cache", cache.active ) );
+    add_option( opt_bool( "dot_tick_scheduler", dot_tick_scheduler.active ) );
     add_option( opt_bool( "karazhan_trinkets_paired", karazhan_trinkets_paired ) );
 }
 
@@ -10487,6 +10804,14 @@ void player_t::analyze( sim_t& s )
 
   collected_data.analyze( *this );
 
+  if ( s.filter_proc_callbacks > 1 && callbacks.filtered_visits + callbacks.filtered_skips > 0 )
+  {
+    uint64_t total = callbacks.filtered_visits + callbacks.filtered_skips;
+    s.out_std.printf( "Player %s: Pre-filtered proc callbacks skipped %llu of %llu callback visits (%.1f%%).",
+                      name(), static_cast<unsigned long long>( callbacks.filtered_skips ),
+                      static_cast<unsigned long long>( total ), 100.0 * callbacks.filtered_skips / total );
+  }
+
   range::for_each( buff_list, []( buff_t* b ) { b -> analyze(); } );
 
   range::sort( stats_list, []( const stats_t* l, const stats_t* r ) { return l -> name_str < r -> name_str; } );
@@ -10690,26 +11015,26 @@ void player_stat_cache_t::invalidate_all()
 {
   if ( ! active ) return;
 
-  range::fill( valid, false );
-  range::fill( spell_power_valid, false );
-  range::fill( player_mult_valid, false );
-  range::fill( player_heal_mult_valid, false );
+  valid.reset();
+  spell_power_valid.reset();
+  player_mult_valid.reset();
+  player_heal_mult_valid.reset();
 }
 
-/* Invalidate ALL stats
+/* Invalidate a single stat
  */
 void player_stat_cache_t::invalidate( cache_e c )
 {
   switch ( c )
   {
     case CACHE_SPELL_POWER:
-      range::fill( spell_power_valid, false );
+      spell_power_valid.reset();
       break;
     case CACHE_PLAYER_DAMAGE_MULTIPLIER:
-      range::fill( player_mult_valid, false );
+      player_mult_valid.reset();
       break;
     case CACHE_PLAYER_HEAL_MULTIPLIER:
-      range::fill( player_heal_mult_valid, false );
+      player_heal_mult_valid.reset();
       break;
     default:
       valid[ c ] = false;
@@ -10717,6 +11042,59 @@ void player_stat_cache_t::invalidate( cache_e c )
   }
 }
 
+/* Invalidate all stats in the mask
+ */
+void player_stat_cache_t::invalidate( const mask_t& mask )
+{
+  valid &= ~mask;
+
+  if ( mask.test( CACHE_SPELL_POWER ) )
+    spell_power_valid.reset();
+  if ( mask.test( CACHE_PLAYER_DAMAGE_MULTIPLIER ) )
+    player_mult_valid.reset();
+  if ( mask.test( CACHE_PLAYER_HEAL_MULTIPLIER ) )
+    player_heal_mult_valid.reset();
+}
+
+/* Declare that invalidating cache c also invalidates cache dependent
+ */
+void player_stat_cache_t::add_dependency( cache_e c, cache_e dependent )
+{
+  assert( c > CACHE_NONE && c < CACHE_MAX && dependent > CACHE_NONE && dependent < CACHE_MAX );
+
+  dependents[ c ].set( dependent );
+}
+
+/* Compile the declared dependencies into the invalidation mask of each cache, that is, the cache
+ * itself and everything that transitively depends on it.
+ */
+void player_stat_cache_t::compile_dependencies()
+{
+  for ( size_t c = 0; c < CACHE_MAX; ++c )
+  {
+    mask_t mask;
+    mask.set( c );
+
+    // Expand the mask until no new dependents are found. The graph is tiny, and cycles are
+    // harmless.
+    mask_t expanded;
+    while ( expanded != mask )
+    {
+      mask_t frontier = mask & ~expanded;
+      expanded = mask;
+      for ( size_t d = 0; d < CACHE_MAX; ++d )
+      {
+        if ( frontier.test( d ) )
+          mask |= dependents[ d ];
+      }
+    }
+
+    invalidation_mask[ c ] = mask;
+  }
+
+  compiled = true;
+}
+
 /* Helper function to access attribute cache functions by attribute-enumeration
  */
 double player_stat_cache_t::get_attribute( attribute_e a ) const
@@ -11765,12 +12143,35 @@ action_t* player_t::select_action( const action_priority_list_t& list )
     if ( a -> option.wait_on_ready == 1 )
       break;
 
-    if ( a -> ready() )
+    // Skip actions that are known to be on cooldown without calling into ready() (and the class
+    // module overrides of it). Actions whose overrides can make them ready while the cooldown is
+    // down opt out through action_t::ready_ignores_cooldown.
+    if ( a -> ready_gated && sim -> skip_unready_actions &&
+         a -> earliest_ready_time() > sim -> current_time() )
+    {
+      if ( sim -> profile_apl )
+      {
+        a -> apl_profile.evaluations++;
+        a -> apl_profile.fail_cooldown++;
+      }
+      continue;
+    }
+
+    if ( sim -> profile_apl ? a -> profiled_ready() : a -> ready() )
     {
       // Execute variable operation, and continue processing
       if ( a -> type == ACTION_VARIABLE )
       {
-        a -> execute();
+        if ( sim -> profile_apl )
+        {
+          a -> apl_profile.start();
+          a -> execute();
+          a -> apl_profile.stop();
+        }
+        else
+        {
+          a -> execute();
+        }
         continue;
       }
       // Call_action_list action, don't execute anything, but rather recurse
@@ -11806,31 +12207,91 @@ action_t* player_t::select_action( const action_priority_list_t& list )
   return 0;
 }
 
-player_t* player_t::actor_by_name_str( const std::string& name ) const
+// player_t::variable_value ================================================
+
+double player_t::variable_value( action_variable_t* var )
 {
-  // Check player pets first
-  for ( size_t i = 0; i < pet_list.size(); i++ )
+  if ( var -> lazy_ops.empty() )
+    return var -> current_value_;
+
+  return lazy_variable_value( *this, *var, lazy_variables.horizon );
+}
+
+// player_t::resolve_lazy_variables ========================================
+
+// Evaluate all operations queued so far in the APL pass, so that later reads do not evaluate them
+// in a different state (pool_resource evaluates the next line with temporarily raised resources).
+
+void player_t::resolve_lazy_variables()
+{
+  for ( action_variable_t* var : lazy_variables.touched )
+  {
+    for ( size_t i = 0; i < var -> lazy_ops.size(); ++i )
+      lazy_variable_op_value( *this, *var, i );
+  }
+}
+
+// player_t::end_lazy_variable_pass ========================================
+
+// Commit the variables operated on during the APL pass. Pass scoped variables are not read after
+// the pass, and are overwritten before they are read in the next pass, so their unread operations
+// can be dropped, unless skill based random line selection made the pass walk the list out of
+// order. Final values are computed before any of them is committed, as evaluating operations reads
+// other variables as of the operation's position in the pass.
+
+void player_t::end_lazy_variable_pass()
+{
+  lazy_variables.active = false;
+
+  bool commit_all = current.skill - current.skill_debuff != 1;
+
+  lazy_variables.values.clear();
+  for ( action_variable_t* var : lazy_variables.touched )
   {
-    if ( util::str_compare_ci( pet_list[ i ] -> name_str, name ) )
-      return pet_list[ i ];
+    bool commit = commit_all || ! var -> pass_scoped;
+    lazy_variables.values.push_back( commit ? lazy_variable_value( *this, *var, lazy_variables.horizon )
+                                            : var -> current_value_ );
+  }
+
+  for ( size_t i = 0; i < lazy_variables.touched.size(); ++i )
+  {
+    action_variable_t* var = lazy_variables.touched[ i ];
+    if ( var -> current_value_ != lazy_variables.values[ i ] )
+    {
+      var -> current_value_ = lazy_variables.values[ i ];
+      var -> version++;
+    }
+    var -> lazy_ops.clear();
   }
 
+  lazy_variables.touched.clear();
+}
+
+player_t* player_t::actor_by_name_str( const std::string& name ) const
+{
+  // Check player pets first
+  player_t* actor = sim -> actor_index.find( sim -> actor_list, name, [ this ]( const player_t* p ) {
+    return range::find_if( pet_list, [ p ]( const pet_t* pet ) { return pet == p; } ) != pet_list.end();
+  } );
+
   // Check harmful targets list
-  for ( size_t i = 0; i < sim -> target_list.size(); i++ )
+  if ( ! actor )
   {
-    if ( util::str_compare_ci( sim -> target_list[ i ] -> name_str, name ) )
-      return sim -> target_list[ i ];
+    actor = sim -> actor_index.find( sim -> actor_list, name, [ this ]( player_t* p ) {
+      return range::find( sim -> target_list, p ) != sim -> target_list.end();
+    } );
   }
 
   // Finally, check player (non pet list), don't support targeting other
   // people's pets for now
-  for ( size_t i = 0; i < sim -> player_no_pet_list.size(); i++ )
+  if ( ! actor )
   {
-    if ( util::str_compare_ci( sim -> player_no_pet_list[ i ] -> name_str, name ) )
-      return sim -> player_no_pet_list[ i ];
+    actor = sim -> actor_index.find( sim -> actor_list, name, [ this ]( player_t* p ) {
+      return range::find( sim -> player_no_pet_list, p ) != sim -> player_no_pet_list.end();
+    } );
   }
 
-  return 0;
+  return actor;
 }
 
 bool player_t::artifact_enabled() const
@@ -11961,11 +12422,10 @@ void player_t::adjust_global_cooldown( haste_type_e haste_type )
   // We need to adjust the event (GCD is already elapsing)
   if ( readying )
   {
-    // GCD speeding up, recreate the event
+    // GCD speeding up, move the event earlier
     if ( delta < 1 )
     {
-      event_t::cancel( readying );
-      readying = make_event<player_ready_event_t>( *sim, *this, new_remains );
+      readying -> adjust( new_remains );
     }
     // GCD slowing down, just reschedule into future
     else
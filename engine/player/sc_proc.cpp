@@ -648,6 +648,8 @@ void proc_attack_t::override_data( const special_effect_t& e )
 spell_t* special_effect_t::initialize_offensive_spell_action() const
 {
   auto spell = new proc_spell_t( *this );
+  // The generic proc spell only reads the state fields its snapshot flags cover
+  spell -> partial_snapshot = true;
   spell -> init();
   return spell;
 }
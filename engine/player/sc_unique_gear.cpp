@@ -472,7 +472,7 @@ struct jade_spirit_check_func
     if ( buff.player -> resources.max[ RESOURCE_MANA ] <= 0.0 )
       return false;
 
-    return buff.player -> resources.pct( RESOURCE_MANA ) < 0.25;
+    return buff.player -> resource_current( RESOURCE_MANA ) / buff.player -> resources.max[ RESOURCE_MANA ] < 0.25;
   }
 };
 
@@ -872,13 +872,13 @@ void gem::capacitive_primal( special_effect_t& effect )
       }
     }
 
-    void trigger( action_t* action, void* call_data ) override
+    bool can_trigger( const action_t* action ) const override
     {
       // Flurry of Xuen and Capacitance cannot proc Capacitance
       if ( action -> id == 147891 || action -> id == 146194 || action -> id == 137597 )
-        return;
+        return false;
 
-      dbc_proc_callback_t::trigger( action, call_data );
+      return dbc_proc_callback_t::can_trigger( action );
     }
   };
 
@@ -910,13 +910,13 @@ void gem::courageous_primal( special_effect_t& effect )
       dbc_proc_callback_t( data.player, data )
     { }
 
-    virtual void trigger( action_t* action, void* call_data ) override
+    bool can_trigger( const action_t* action ) const override
     {
-      spell_base_t* spell = debug_cast<spell_base_t*>( action );
+      const spell_base_t* spell = debug_cast<const spell_base_t*>( action );
       if ( ! spell -> procs_courageous_primal_diamond )
-        return;
+        return false;
 
-      dbc_proc_callback_t::trigger( action, call_data );
+      return dbc_proc_callback_t::can_trigger( action );
     }
   };
 
@@ -2269,13 +2269,13 @@ struct flurry_of_xuen_cb_t : public dbc_proc_callback_t
     dbc_proc_callback_t( p, effect )
   { }
 
-  void trigger( action_t* action, void* call_data ) override
+  bool can_trigger( const action_t* action ) const override
   {
     // Flurry of Xuen, and Lightning Strike cannot proc Flurry of Xuen
     if ( action -> id == 147891 || action -> id == 146194 || action -> id == 137597 )
-      return;
+      return false;
 
-    dbc_proc_callback_t::trigger( action, call_data );
+    return dbc_proc_callback_t::can_trigger( action );
   }
 };
 
@@ -2328,12 +2328,12 @@ struct essence_of_yulon_cb_t : public dbc_proc_callback_t
     dbc_proc_callback_t( p, effect )
   { }
 
-  void trigger( action_t* action, void* call_data ) override
+  bool can_trigger( const action_t* action ) const override
   {
     if ( action -> id == 148008 ) // dot direct damage ticks can't proc itself
-      return;
+      return false;
 
-    dbc_proc_callback_t::trigger( action, call_data );
+    return dbc_proc_callback_t::can_trigger( action );
   }
 };
 
@@ -2811,7 +2811,7 @@ struct empty_drinking_horn_damage_t : public melee_attack_t
 
     const actor_target_data_t* td = player -> get_target_data( target );
 
-    m *= td -> debuff.fel_burn -> current_stack;
+    m *= td -> debuff.fel_burn -> check();
 
     return m;
   }
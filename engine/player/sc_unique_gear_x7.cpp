@@ -2619,7 +2619,7 @@ struct poisoned_dreams_damage_driver_t : public dbc_proc_callback_t
     actor_target_data_t* td = listener -> get_target_data( trigger_state -> target );
     damage -> base_multiplier = 1.0; // Reset base multiplier before each trigger so we scale linearly with #stacks, not exponentially.
     damage -> target = trigger_state -> target;
-    damage -> base_multiplier *= td -> debuff.poisoned_dreams -> current_stack;
+    damage -> base_multiplier *= td -> debuff.poisoned_dreams -> check();
     damage -> execute();
   }
 
@@ -1947,6 +1947,91 @@ void print_html_sample_sequence_table_entry(
   os << "</tr>\n";
 }
 
+// print_html_player_apl_profile =============================================
+
+void print_html_player_apl_profile( report::sc_html_stream& os,
+                                    const player_t& p )
+{
+  const sim_t& sim = *( p.sim );
+
+  std::vector<const action_t*> lines;
+  double total_time = 0;
+  for ( const action_t* a : p.action_list )
+  {
+    if ( a->apl_profile.evaluations == 0 || !a->action_list )
+      continue;
+
+    lines.push_back( a );
+    total_time += a->apl_profile.time();
+  }
+
+  if ( lines.empty() )
+    return;
+
+  range::sort( lines, []( const action_t* l, const action_t* r ) {
+    return l->apl_profile.time() >
+           r->apl_profile.time();
+  } );
+
+  os << "<h4>APL Line Profile</h4>\n"
+     << "<table class=\"sc sort\">\n"
+     << "<tr>\n"
+     << "<th class=\"left\">list</th>\n"
+     << "<th class=\"right\">#</th>\n"
+     << "<th class=\"left\">action</th>\n"
+     << "<th class=\"right\">evaluations</th>\n"
+     << "<th class=\"right\">ready%</th>\n"
+     << "<th class=\"right\">cooldown%</th>\n"
+     << "<th class=\"right\">resource%</th>\n"
+     << "<th class=\"right\">condition%</th>\n"
+     << "<th class=\"right\">time (ms)</th>\n"
+     << "<th class=\"right\">time%</th>\n"
+     << "<th class=\"right\">ns/eval</th>\n"
+     << "</tr>\n";
+
+  for ( size_t i = 0; i < lines.size(); ++i )
+  {
+    const action_t* a = lines[ i ];
+    const apl_profile_t& prof = a->apl_profile;
+    double n = static_cast<double>( prof.evaluations );
+    double t = prof.time();
+
+    os << "<tr";
+    if ( i & 1 )
+    {
+      os << " class=\"odd\"";
+    }
+    os << ">\n";
+
+    os.format(
+        "<td class=\"left\">%s</td>\n"
+        "<td class=\"right\">%c</td>\n"
+        "<td class=\"left\">%s</td>\n"
+        "<td class=\"right\">%.1f</td>\n"
+        "<td class=\"right\">%.2f</td>\n"
+        "<td class=\"right\">%.2f</td>\n"
+        "<td class=\"right\">%.2f</td>\n"
+        "<td class=\"right\">%.2f</td>\n"
+        "<td class=\"right\">%.3f</td>\n"
+        "<td class=\"right\">%.2f</td>\n"
+        "<td class=\"right\">%.1f</td>\n"
+        "</tr>\n",
+        util::encode_html( a->action_list->name_str.c_str() ).c_str(),
+        a->marker ? a->marker : ' ',
+        util::encode_html( a->signature_str.c_str() ).c_str(),
+        n / sim.iterations,
+        100.0 * prof.ready / n,
+        100.0 * prof.fail_cooldown / n,
+        100.0 * prof.fail_resource / n,
+        100.0 * prof.fail_condition / n,
+        t * 1e3,
+        total_time > 0 ? 100.0 * t / total_time : 0.0,
+        t * 1e9 / n );
+  }
+
+  os << "</table>\n";
+}
+
 // print_html_player_action_priority_list =====================================
 
 void print_html_player_action_priority_list( report::sc_html_stream& os,
@@ -2031,6 +2116,11 @@ void print_html_player_action_priority_list( report::sc_html_stream& os,
     os << "</table>\n";
   }
 
+  if ( sim.profile_apl )
+  {
+    print_html_player_apl_profile( os, p );
+  }
+
   // Sample Sequences
 
   if ( !p.collected_data.action_sequence.empty() && !p.is_enemy()  )
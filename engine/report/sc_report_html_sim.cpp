@@ -1496,6 +1496,31 @@ void print_html_( report::sc_html_stream& os, sim_t& sim )
   os << "});\n";
   os << "</script>\n";
 
+  // Click-to-sort for tables marked sortable (APL line profile)
+  if ( sim.profile_apl )
+  {
+    os << "<script type=\"text/javascript\">\n";
+    os << "jQuery(document).ready(function() {\n";
+    os << "\tjQuery('table.sort').each(function() {\n";
+    os << "\t\tvar t = jQuery(this);\n";
+    os << "\t\tt.find('tr:first th').css('cursor', 'pointer').click(function() {\n";
+    os << "\t\t\tvar col = jQuery(this).index();\n";
+    os << "\t\t\tvar asc = t.data('sortcol') === col && !t.data('sortasc');\n";
+    os << "\t\t\tt.data('sortcol', col).data('sortasc', asc);\n";
+    os << "\t\t\tvar rows = t.find('tr:gt(0)').get();\n";
+    os << "\t\t\trows.sort(function(a, b) {\n";
+    os << "\t\t\t\tvar x = jQuery(a).children().eq(col).text(), y = jQuery(b).children().eq(col).text();\n";
+    os << "\t\t\t\tvar nx = parseFloat(x), ny = parseFloat(y);\n";
+    os << "\t\t\t\tvar c = ( isNaN(nx) || isNaN(ny) ) ? x.localeCompare(y) : nx - ny;\n";
+    os << "\t\t\t\treturn asc ? c : -c;\n";
+    os << "\t\t\t});\n";
+    os << "\t\t\tjQuery.each(rows, function(i, r) { jQuery(r).toggleClass('odd', ( i & 1 ) === 1); t.append(r); });\n";
+    os << "\t\t});\n";
+    os << "\t});\n";
+    os << "});\n";
+    os << "</script>\n";
+  }
+
   os << "</body>\n\n"
      << "</html>\n";
 }
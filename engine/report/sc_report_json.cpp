@@ -426,6 +426,28 @@ js::sc_js_t to_json( const proc_t& p )
   return node;
 }
 
+void apl_profile_to_json( JsonOutput root, const player_t& p )
+{
+  root.make_array();
+  range::for_each( p.action_list, [ & ]( const action_t* a ) {
+    const apl_profile_t& prof = a -> apl_profile;
+    if ( prof.evaluations == 0 || ! a -> action_list )
+    {
+      return;
+    }
+
+    auto node = root.add();
+    node[ "action_list" ] = a -> action_list -> name_str;
+    node[ "action" ] = a -> signature_str;
+    node[ "evaluations" ] = prof.evaluations;
+    node[ "ready" ] = prof.ready;
+    node[ "fail_cooldown" ] = prof.fail_cooldown;
+    node[ "fail_resource" ] = prof.fail_resource;
+    node[ "fail_condition" ] = prof.fail_condition;
+    node[ "time" ] = prof.time();
+  } );
+}
+
 void stats_to_json( JsonOutput root, const player_t& p )
 {
   root.make_array();
@@ -1246,6 +1268,11 @@ void to_json( JsonOutput& arr, const player_t& p )
     stats_to_json( root[ "stats" ], p );
   }
 
+  if ( p.sim -> profile_apl )
+  {
+    apl_profile_to_json( root[ "apl_profile" ], p );
+  }
+
   gear_to_json( root[ "gear" ], p );
 
   JsonOutput custom = root[ "custom" ];
@@ -1490,6 +1517,7 @@ void to_json( JsonOutput root, const sim_t& sim )
   options_root[ "ignite_sampling_delta" ] =  sim.ignite_sampling_delta;
   options_root[ "fixed_time" ] = sim.fixed_time;
   options_root[ "optimize_expressions" ] = sim.optimize_expressions;
+  options_root[ "profile_apl" ] = sim.profile_apl;
   options_root[ "optimal_raid" ] = sim.optimal_raid;
   options_root[ "log" ] = sim.log;
   options_root[ "debug_each" ] = sim.debug_each;
@@ -36,6 +36,7 @@ struct recharge_event_t : event_t
   {
     assert( cooldown_ -> current_charge < cooldown_ -> charges );
     cooldown_ -> current_charge++;
+    cooldown_ -> version++;
     cooldown_ -> ready = cooldown_t::ready_init();
 
     if ( cooldown_ -> current_charge < cooldown_ -> charges )
@@ -66,6 +67,13 @@ struct recharge_event_t : event_t
 
   static recharge_event_t* cast( event_t* e )
   { return debug_cast<recharge_event_t*>( e ); }
+
+  // Move the recharge event to occur event_duration from now
+  static void adjust_duration( event_t* e, timespan_t event_duration )
+  {
+    cast( e ) -> event_duration_ = event_duration;
+    e -> adjust( event_duration );
+  }
 };
 
 struct ready_trigger_event_t : public player_event_t
@@ -126,7 +134,8 @@ cooldown_t::cooldown_t( const std::string& n, player_t& p ) :
   last_charged( timespan_t::zero() ),
   recharge_multiplier( 1.0 ),
   hasted( false ),
-  action( nullptr )
+  action( nullptr ),
+  version( 0 )
 {}
 
 cooldown_t::cooldown_t( const std::string& n, sim_t& s ) :
@@ -144,7 +153,8 @@ cooldown_t::cooldown_t( const std::string& n, sim_t& s ) :
   last_charged( timespan_t::zero() ),
   recharge_multiplier( 1.0 ),
   hasted( false ),
-  action( nullptr )
+  action( nullptr ),
+  version( 0 )
 {}
 
 // Adjust a dynamic cooldown (reduction) multiplier based on the current action associated with the
@@ -175,12 +185,10 @@ void cooldown_t::adjust_recharge_multiplier()
   {
     remains = recharge_event -> remains();
     new_remains = remains * delta;
-    // Shortened, reschedule the event
+    // Shortened, move the event earlier
     if ( delta < 1 )
     {
-      timespan_t duration_ = recharge_event_t::cast( recharge_event ) -> duration_;
-      event_t::cancel( recharge_event );
-      recharge_event = make_event<recharge_event_t>( sim, this, new_remains, duration_ );
+      recharge_event_t::adjust_duration( recharge_event, new_remains );
     }
     else
     {
@@ -196,6 +204,7 @@ void cooldown_t::adjust_recharge_multiplier()
   }
 
   ready = sim.current_time() + new_remains;
+  version++;
   if ( charges == 1 )
   {
     last_charged = ready;
@@ -204,6 +213,8 @@ void cooldown_t::adjust_recharge_multiplier()
 
 void cooldown_t::adjust( timespan_t amount, bool require_reaction )
 {
+  version++;
+
   // Normal cooldown, just adjust as we see fit
   if ( charges == 1 )
   {
@@ -224,13 +235,11 @@ void cooldown_t::adjust( timespan_t amount, bool require_reaction )
     // Remaining time on the recharge event
     timespan_t remains = recharge_event -> remains() + amount;
 
-    // Didnt recharge a charge, just recreate the recharge event to occur
-    // sooner
+    // Didnt recharge a charge, just move the recharge event to occur at the
+    // new time
     if ( remains > timespan_t::zero() )
     {
-      timespan_t duration_ = recharge_event_t::cast( recharge_event ) -> duration_;
-      event_t::cancel( recharge_event );
-      recharge_event = make_event<recharge_event_t>( sim, this, remains, duration_ );
+      recharge_event_t::adjust_duration( recharge_event, remains );
 
       // If we have no charges, adjust ready time to the new occurrence time
       // of the recharge event, plus a millisecond
@@ -252,14 +261,13 @@ void cooldown_t::adjust( timespan_t amount, bool require_reaction )
       if ( remains < timespan_t::zero() && recharge_event )
       {
         timespan_t duration_ = recharge_event_t::cast( recharge_event ) -> duration_;
-        event_t::cancel( recharge_event );
 
         // Note, the next recharge cycle uses the previous recharge cycle's
         // base duration, if overridden
         timespan_t new_duration = cooldown_duration( this, duration_ );
         new_duration += remains;
 
-        recharge_event = make_event<recharge_event_t>( sim, this, new_duration, duration_ );
+        recharge_event_t::adjust_duration( recharge_event, new_duration );
       }
 
       if ( sim.debug )
@@ -281,6 +289,7 @@ void cooldown_t::adjust( timespan_t amount, bool require_reaction )
 
 void cooldown_t::reset_init()
 {
+  version++;
   ready = ready_init();
   last_start = timespan_t::zero();
   last_charged = timespan_t::zero();
@@ -294,6 +303,7 @@ void cooldown_t::reset_init()
 
 void cooldown_t::reset( bool require_reaction, bool all_charges )
 {
+  version++;
   bool was_down = down();
   ready = ready_init();
   if ( last_start > sim.current_time() )
@@ -346,6 +356,8 @@ void cooldown_t::start( action_t* a, timespan_t _override, timespan_t delay )
     return;
   }
 
+  version++;
+
   if ( delay > timespan_t::zero() )
   {
     event_duration += delay;
@@ -396,14 +408,16 @@ void cooldown_t::start( timespan_t _override, timespan_t delay )
 expr_t* cooldown_t::create_expression( action_t*, const std::string& name_str )
 {
   if ( name_str == "remains" )
-    return make_mem_fn_expr( name_str, *this, &cooldown_t::remains );
+    return make_dependent_expr( sim, make_state_expr<expr_ref_t::REF_COOLDOWN_REMAINS>( name_str, *this ),
+                                { &version }, true );
   else if ( name_str == "duration" )
     return make_ref_expr( name_str, duration );
   else if ( name_str == "up" || name_str == "ready" )
-    return make_mem_fn_expr( name_str, *this, &cooldown_t::up );
+    return make_dependent_expr( sim, make_state_expr<expr_ref_t::REF_COOLDOWN_UP>( name_str, *this ),
+                                { &version }, true );
   else if ( name_str == "charges" )
   {
-    return make_fn_expr( name_str, [ this ]() {
+    return make_dependent_expr( sim, make_fn_expr( name_str, [ this ]() {
       if ( charges <= 1 )
       {
         return up() ? 1.0 : 0.0;
@@ -412,11 +426,11 @@ expr_t* cooldown_t::create_expression( action_t*, const std::string& name_str )
       {
         return as<double>( current_charge );
       }
-    } );
+    } ), { &version }, true );
   }
   else if ( name_str == "charges_fractional" )
   {
-    return make_fn_expr( name_str, [ this ]() {
+    return make_dependent_expr( sim, make_fn_expr( name_str, [ this ]() {
       if ( charges > 1 )
       {
         double charges = current_charge;
@@ -440,7 +454,7 @@ expr_t* cooldown_t::create_expression( action_t*, const std::string& name_str )
           return elapsed / duration;
         }
       }
-    } );
+    } ), { &version }, true );
   }
   else if ( name_str == "recharge_time" )
   {
@@ -54,6 +54,18 @@ void event_t::reschedule( timespan_t delta_time )
   reschedule_time = delta_time;
 }
 
+// event_t::adjust ==========================================================
+
+void event_t::adjust( timespan_t delta_time )
+{
+  if ( _sim.debug )
+    _sim.out_debug.printf( "Adjusting event %s (%d) from %.2f to %.2f", name(), id,
+                           occurs().total_seconds(),
+                           ( _sim.event_mgr.current_time + delta_time ).total_seconds() );
+
+  _sim.event_mgr.adjust_event( this, delta_time );
+}
+
 // event_t::cancel ==========================================================
 
 void event_t::cancel( event_t*& e )
@@ -271,6 +283,36 @@ void event_manager_t::reschedule_event( event_t* e )
   add_event( e, ( e->reschedule_time - current_time ) );
 }
 
+// event_manager_t::adjust_event ============================================
+
+void event_manager_t::adjust_event( event_t* e, timespan_t delta_time )
+{
+  assert( e->scheduled && !e->canceled && "Cannot adjust an unscheduled or canceled event." );
+
+  // Unlink the event from the event list of its time slice, and schedule it again as if it was new
+  uint32_t slice = static_cast<uint32_t>(
+      ( e->time.total_millis() >> wheel_shift ) & wheel_mask );
+
+  event_t** prev = &( timing_wheel[ slice ] );
+  while ( *prev != e )
+  {
+    assert( *prev && "Adjusted event is not in the timing wheel." );
+    prev = &( ( *prev )->next );
+  }
+  *prev = e->next;
+  events_remaining--;
+
+#if ACTOR_EVENT_BOOKKEEPING
+  // add_event() counts the event for the actor again
+  if ( sim->debug && e->actor )
+  {
+    e->actor->event_counter--;
+  }
+#endif
+
+  add_event( e, delta_time );
+}
+
 // event_manager_t::execute =================================================
 
 bool event_manager_t::execute()
@@ -310,6 +352,8 @@ bool event_manager_t::execute()
       if ( sim->debug )
         sim->out_debug.printf( "Executing event: %s", e->name() );
 
+      sim->state_epoch++;
+
       if ( monitor_cpu )
       {
 #if ACTOR_EVENT_BOOKKEEPING
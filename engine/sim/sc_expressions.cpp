@@ -9,29 +9,93 @@
 namespace expression
 {
 
+// State Accessors ==========================================================
+
+template <>
+double state_value<expr_ref_t::REF_BUFF_UP>( const buff_t& b )
+{
+  return b.check() > 0;
+}
+
+template <>
+double state_value<expr_ref_t::REF_BUFF_DOWN>( const buff_t& b )
+{
+  return b.check() <= 0;
+}
+
+template <>
+double state_value<expr_ref_t::REF_BUFF_STACK>( const buff_t& b )
+{
+  return b.check();
+}
+
+template <>
+double state_value<expr_ref_t::REF_BUFF_REMAINS>( const buff_t& b )
+{
+  return b.remains().total_seconds();
+}
+
+template <>
+double state_value<expr_ref_t::REF_COOLDOWN_UP>( const cooldown_t& c )
+{
+  return c.up();
+}
+
+template <>
+double state_value<expr_ref_t::REF_COOLDOWN_REMAINS>( const cooldown_t& c )
+{
+  return c.remains().total_seconds();
+}
+
+template <>
+double state_value<expr_ref_t::REF_DOT_TICKING>( const dot_t& d )
+{
+  return d.is_ticking();
+}
+
+template <>
+double state_value<expr_ref_t::REF_DOT_REMAINS>( const dot_t& d )
+{
+  return d.remains().total_seconds();
+}
+
 namespace
 {  // ANONYMOUS ====================================================
 
 const bool EXPRESSION_DEBUG = false;
 // Unary Operators ==========================================================
 
-template <class F>
-class expr_unary_t : public expr_t
+class unary_base_t : public expr_t
 {
+public:
   expr_t* input;
 
-public:
-  expr_unary_t( const std::string& n, token_e o, expr_t* i )
+  unary_base_t( const std::string& n, token_e o, expr_t* i )
     : expr_t( n, o ), input( i )
   {
     assert( input );
   }
 
-  ~expr_unary_t()
+  ~unary_base_t()
   {
     delete input;
   }
 
+  bool dependencies( expr_deps_t& deps ) const override
+  {
+    return input->dependencies( deps );
+  }
+};
+
+template <class F>
+class expr_unary_t : public unary_base_t
+{
+public:
+  expr_unary_t( const std::string& n, token_e o, expr_t* i )
+    : unary_base_t( n, o, i )
+  {
+  }
+
   double evaluate() override  // override
   {
     return F()( input->eval() );
@@ -106,6 +170,11 @@ public:
     delete left;
     delete right;
   }
+
+  bool dependencies( expr_deps_t& deps ) const override
+  {
+    return left->dependencies( deps ) && right->dependencies( deps );
+  }
 };
 
 class logical_and_t : public binary_base_t
@@ -150,6 +219,32 @@ public:
   }
 };
 
+// Binary operator with one of the operands reduced to a constant
+class reduced_binary_base_t : public expr_t
+{
+public:
+  expr_t* operand;
+  double constant;
+  bool constant_left;
+
+  reduced_binary_base_t( const std::string& n, token_e o, expr_t* e, double c,
+                         bool cl )
+    : expr_t( n, o ), operand( e ), constant( c ), constant_left( cl )
+  {
+    assert( operand );
+  }
+
+  ~reduced_binary_base_t()
+  {
+    delete operand;
+  }
+
+  bool dependencies( expr_deps_t& deps ) const override
+  {
+    return operand->dependencies( deps );
+  }
+};
+
 template <template <typename> class F>
 class expr_binary_t : public binary_base_t
 {
@@ -699,17 +794,15 @@ public:
       if ( EXPRESSION_DEBUG )
         printf( "Reduced %*d %s (%s) binary expression left\n", spacing, id(),
                 name(), left->name() );
-      struct left_reduced_t : public expr_t
+      struct left_reduced_t : public reduced_binary_base_t
       {
-        double left;
-        expr_t* right;
         left_reduced_t( const std::string& n, token_e o, double l, expr_t* r )
-          : expr_t( n, o ), left( l ), right( r )
+          : reduced_binary_base_t( n, o, r, l, true )
         {
         }
         double evaluate() override
         {
-          return F<double>()( left, right->eval() );
+          return F<double>()( constant, operand->eval() );
         }
       };
       expr_t* reduced = new left_reduced_t(
@@ -724,17 +817,15 @@ public:
       if ( EXPRESSION_DEBUG )
         printf( "Reduced %*d %s (%s) binary expression right\n", spacing, id(),
                 name(), right->name() );
-      struct right_reduced_t : public expr_t
+      struct right_reduced_t : public reduced_binary_base_t
       {
-        expr_t* left;
-        double right;
         right_reduced_t( const std::string& n, token_e o, expr_t* l, double r )
-          : expr_t( n, o ), left( l ), right( r )
+          : reduced_binary_base_t( n, o, l, r, false )
         {
         }
         double evaluate() override
         {
-          return F<double>()( left->eval(), right );
+          return F<double>()( operand->eval(), constant );
         }
       };
       expr_t* reduced = new right_reduced_t(
@@ -794,6 +885,679 @@ expr_t* select_analyze_binary( const std::string& name, token_e op,
   }
 }
 
+// Compiled Expressions =====================================================
+
+// An optimized expression tree can be flattened into a postfix instruction array, evaluated with a
+// small stack machine. Operator nodes are dissolved into opcodes, plain reference leaves are read
+// through direct pointers, and only the remaining (opaque) leaves are evaluated through their
+// virtual evaluate().
+
+enum opcode_e
+{
+  OP_CONST = 0,
+  OP_EXPR,
+  OP_REF_DOUBLE,
+  OP_REF_INT,
+  OP_REF_UNSIGNED,
+  OP_REF_BOOL,
+  OP_REF_TIMESPAN,
+  OP_BUFF_UP,
+  OP_BUFF_DOWN,
+  OP_BUFF_STACK,
+  OP_BUFF_REMAINS,
+  OP_COOLDOWN_UP,
+  OP_COOLDOWN_REMAINS,
+  OP_DOT_TICKING,
+  OP_DOT_REMAINS,
+  OP_AND,  // Short circuits to 0 if the top of the stack is 0, otherwise pops it
+  OP_OR,   // Short circuits to 1 if the top of the stack is non-zero, otherwise pops it
+  OP_BOOL,
+  OP_XOR,
+  OP_ADD,
+  OP_SUB,
+  OP_MULT,
+  OP_DIV,
+  OP_EQ,
+  OP_NOTEQ,
+  OP_LT,
+  OP_LTEQ,
+  OP_GT,
+  OP_GTEQ,
+  OP_NEG,
+  OP_NOT,
+  OP_ABS,
+  OP_FLOOR,
+  OP_CEIL
+};
+
+struct instruction_t
+{
+  opcode_e op;
+  // Binary operators take the right operand from value instead of the stack
+  bool immediate;
+  // Instruction to continue from when AND/OR short circuits
+  unsigned jump;
+  union
+  {
+    double value;
+    expr_t* expr;
+    const void* ref;
+  };
+
+  instruction_t( opcode_e o ) : op( o ), immediate( false ), jump( 0 ), value( 0 )
+  { }
+};
+
+const int MAX_COMPILED_STACK = 32;
+
+class expr_compiler_t
+{
+  std::vector<instruction_t>& code;
+  int depth, max_depth;
+
+  void push( const instruction_t& i, int stack_delta )
+  {
+    code.push_back( i );
+    depth += stack_delta;
+    max_depth = std::max( max_depth, depth );
+  }
+
+  bool binary_op( token_e tok, opcode_e& op )
+  {
+    switch ( tok )
+    {
+      case TOK_XOR:   op = OP_XOR;   return true;
+      case TOK_ADD:   op = OP_ADD;   return true;
+      case TOK_SUB:   op = OP_SUB;   return true;
+      case TOK_MULT:  op = OP_MULT;  return true;
+      case TOK_DIV:   op = OP_DIV;   return true;
+      case TOK_EQ:    op = OP_EQ;    return true;
+      case TOK_NOTEQ: op = OP_NOTEQ; return true;
+      case TOK_LT:    op = OP_LT;    return true;
+      case TOK_LTEQ:  op = OP_LTEQ;  return true;
+      case TOK_GT:    op = OP_GT;    return true;
+      case TOK_GTEQ:  op = OP_GTEQ;  return true;
+      default:                       return false;
+    }
+  }
+
+  bool unary_op( token_e tok, opcode_e& op )
+  {
+    switch ( tok )
+    {
+      case TOK_MINUS: op = OP_NEG;   return true;
+      case TOK_NOT:   op = OP_NOT;   return true;
+      case TOK_ABS:   op = OP_ABS;   return true;
+      case TOK_FLOOR: op = OP_FLOOR; return true;
+      case TOK_CEIL:  op = OP_CEIL;  return true;
+      default:                       return false;
+    }
+  }
+
+  void emit_leaf( expr_t* e )
+  {
+    instruction_t i( OP_EXPR );
+    expr_ref_t ref = e->reference();
+    switch ( ref.type )
+    {
+      case expr_ref_t::REF_DOUBLE:   i.op = OP_REF_DOUBLE;   break;
+      case expr_ref_t::REF_INT:      i.op = OP_REF_INT;      break;
+      case expr_ref_t::REF_UNSIGNED: i.op = OP_REF_UNSIGNED; break;
+      case expr_ref_t::REF_BOOL:     i.op = OP_REF_BOOL;     break;
+      case expr_ref_t::REF_TIMESPAN: i.op = OP_REF_TIMESPAN; break;
+      case expr_ref_t::REF_BUFF_UP:          i.op = OP_BUFF_UP;          break;
+      case expr_ref_t::REF_BUFF_DOWN:        i.op = OP_BUFF_DOWN;        break;
+      case expr_ref_t::REF_BUFF_STACK:       i.op = OP_BUFF_STACK;       break;
+      case expr_ref_t::REF_BUFF_REMAINS:     i.op = OP_BUFF_REMAINS;     break;
+      case expr_ref_t::REF_COOLDOWN_UP:      i.op = OP_COOLDOWN_UP;      break;
+      case expr_ref_t::REF_COOLDOWN_REMAINS: i.op = OP_COOLDOWN_REMAINS; break;
+      case expr_ref_t::REF_DOT_TICKING:      i.op = OP_DOT_TICKING;      break;
+      case expr_ref_t::REF_DOT_REMAINS:      i.op = OP_DOT_REMAINS;      break;
+      default:                                               break;
+    }
+
+    if ( i.op == OP_EXPR )
+      i.expr = e;
+    else
+      i.ref = ref.ptr;
+
+    push( i, 1 );
+  }
+
+public:
+  expr_compiler_t( std::vector<instruction_t>& c ) : code( c ), depth( 0 ), max_depth( 0 )
+  { }
+
+  int stack_size() const
+  {
+    return max_depth;
+  }
+
+  void emit( expr_t* e )
+  {
+    double v;
+    opcode_e op;
+
+    if ( e->is_constant( &v ) )
+    {
+      instruction_t i( OP_CONST );
+      i.value = v;
+      push( i, 1 );
+    }
+    else if ( binary_base_t* b = dynamic_cast<binary_base_t*>( e ) )
+    {
+      if ( b->op_ == TOK_AND || b->op_ == TOK_OR )
+      {
+        emit( b->left );
+        size_t jump_index = code.size();
+        push( instruction_t( b->op_ == TOK_AND ? OP_AND : OP_OR ), -1 );
+        emit( b->right );
+        push( instruction_t( OP_BOOL ), 0 );
+        code[ jump_index ].jump = as<unsigned>( code.size() );
+      }
+      else if ( binary_op( b->op_, op ) )
+      {
+        emit( b->left );
+        emit( b->right );
+        push( instruction_t( op ), -1 );
+      }
+      else
+      {
+        emit_leaf( e );
+      }
+    }
+    else if ( reduced_binary_base_t* r = dynamic_cast<reduced_binary_base_t*>( e ) )
+    {
+      if ( !binary_op( r->op_, op ) )
+      {
+        emit_leaf( e );
+      }
+      else if ( r->constant_left )
+      {
+        instruction_t c( OP_CONST );
+        c.value = r->constant;
+        push( c, 1 );
+        emit( r->operand );
+        push( instruction_t( op ), -1 );
+      }
+      else
+      {
+        emit( r->operand );
+        instruction_t i( op );
+        i.immediate = true;
+        i.value     = r->constant;
+        push( i, 0 );
+      }
+    }
+    else if ( unary_base_t* u = dynamic_cast<unary_base_t*>( e ) )
+    {
+      if ( unary_op( u->op_, op ) )
+      {
+        emit( u->input );
+        push( instruction_t( op ), 0 );
+      }
+      else
+      {
+        emit_leaf( e );
+      }
+    }
+    else
+    {
+      emit_leaf( e );
+    }
+  }
+};
+
+double execute( const std::vector<instruction_t>& code )
+{
+  double stack[ MAX_COMPILED_STACK ];
+  int sp         = -1;
+  size_t pc      = 0;
+  size_t n_instr = code.size();
+
+  while ( pc < n_instr )
+  {
+    const instruction_t& i = code[ pc++ ];
+
+    switch ( i.op )
+    {
+      case OP_CONST:
+        stack[ ++sp ] = i.value;
+        continue;
+      case OP_EXPR:
+        stack[ ++sp ] = i.expr->eval();
+        continue;
+      case OP_REF_DOUBLE:
+        stack[ ++sp ] = *static_cast<const double*>( i.ref );
+        continue;
+      case OP_REF_INT:
+        stack[ ++sp ] = static_cast<double>( *static_cast<const int*>( i.ref ) );
+        continue;
+      case OP_REF_UNSIGNED:
+        stack[ ++sp ] = static_cast<double>( *static_cast<const unsigned*>( i.ref ) );
+        continue;
+      case OP_REF_BOOL:
+        stack[ ++sp ] = static_cast<double>( *static_cast<const bool*>( i.ref ) );
+        continue;
+      case OP_REF_TIMESPAN:
+        stack[ ++sp ] = static_cast<const timespan_t*>( i.ref )->total_seconds();
+        continue;
+      case OP_BUFF_UP:
+        stack[ ++sp ] = state_value<expr_ref_t::REF_BUFF_UP>( *static_cast<const buff_t*>( i.ref ) );
+        continue;
+      case OP_BUFF_DOWN:
+        stack[ ++sp ] = state_value<expr_ref_t::REF_BUFF_DOWN>( *static_cast<const buff_t*>( i.ref ) );
+        continue;
+      case OP_BUFF_STACK:
+        stack[ ++sp ] = state_value<expr_ref_t::REF_BUFF_STACK>( *static_cast<const buff_t*>( i.ref ) );
+        continue;
+      case OP_BUFF_REMAINS:
+        stack[ ++sp ] = state_value<expr_ref_t::REF_BUFF_REMAINS>( *static_cast<const buff_t*>( i.ref ) );
+        continue;
+      case OP_COOLDOWN_UP:
+        stack[ ++sp ] = state_value<expr_ref_t::REF_COOLDOWN_UP>( *static_cast<const cooldown_t*>( i.ref ) );
+        continue;
+      case OP_COOLDOWN_REMAINS:
+        stack[ ++sp ] = state_value<expr_ref_t::REF_COOLDOWN_REMAINS>( *static_cast<const cooldown_t*>( i.ref ) );
+        continue;
+      case OP_DOT_TICKING:
+        stack[ ++sp ] = state_value<expr_ref_t::REF_DOT_TICKING>( *static_cast<const dot_t*>( i.ref ) );
+        continue;
+      case OP_DOT_REMAINS:
+        stack[ ++sp ] = state_value<expr_ref_t::REF_DOT_REMAINS>( *static_cast<const dot_t*>( i.ref ) );
+        continue;
+      case OP_AND:
+        if ( stack[ sp ] == 0 )
+        {
+          stack[ sp ] = 0;
+          pc          = i.jump;
+        }
+        else
+          --sp;
+        continue;
+      case OP_OR:
+        if ( stack[ sp ] != 0 )
+        {
+          stack[ sp ] = 1;
+          pc          = i.jump;
+        }
+        else
+          --sp;
+        continue;
+      case OP_BOOL:
+        stack[ sp ] = stack[ sp ] != 0;
+        continue;
+      case OP_NEG:
+        stack[ sp ] = -stack[ sp ];
+        continue;
+      case OP_NOT:
+        stack[ sp ] = !stack[ sp ];
+        continue;
+      case OP_ABS:
+        stack[ sp ] = std::fabs( stack[ sp ] );
+        continue;
+      case OP_FLOOR:
+        stack[ sp ] = std::floor( stack[ sp ] );
+        continue;
+      case OP_CEIL:
+        stack[ sp ] = std::ceil( stack[ sp ] );
+        continue;
+      default:
+        break;
+    }
+
+    // Binary operators
+    double right = i.immediate ? i.value : stack[ sp-- ];
+    double& left = stack[ sp ];
+
+    switch ( i.op )
+    {
+      case OP_XOR:   left = bool( left != 0 ) != bool( right != 0 ); break;
+      case OP_ADD:   left = left + right;  break;
+      case OP_SUB:   left = left - right;  break;
+      case OP_MULT:  left = left * right;  break;
+      case OP_DIV:   left = left / right;  break;
+      case OP_EQ:    left = left == right; break;
+      case OP_NOTEQ: left = left != right; break;
+      case OP_LT:    left = left < right;  break;
+      case OP_LTEQ:  left = left <= right; break;
+      case OP_GT:    left = left > right;  break;
+      case OP_GTEQ:  left = left >= right; break;
+      default:       assert( false );      break;
+    }
+  }
+
+  assert( sp == 0 );
+  return stack[ 0 ];
+}
+
+class compiled_expr_t : public expr_t
+{
+  action_t* action;
+  expr_t* tree;
+  std::vector<instruction_t> code;
+  bool verify;
+
+public:
+  compiled_expr_t( action_t* a, expr_t* t, std::vector<instruction_t>& c, bool v )
+    : expr_t( t->name(), t->op_ ), action( a ), tree( t ), verify( v )
+  {
+    code.swap( c );
+  }
+
+  ~compiled_expr_t()
+  {
+    delete tree;
+  }
+
+  bool dependencies( expr_deps_t& deps ) const override
+  {
+    return tree->dependencies( deps );
+  }
+
+  double evaluate() override  // override
+  {
+    double value = execute( code );
+    if ( !verify )
+      return value;
+
+    // Note, verification evaluates leaves twice, so expressions with side effects (e.g., rng) may
+    // report differences
+    double tree_value = tree->eval();
+    if ( value != tree_value && !( std::isnan( value ) && std::isnan( tree_value ) ) )
+    {
+      action->sim->errorf( "%s-%s: Compiled expression '%s' evaluated to %f, expression tree to %f",
+                           action->player->name(), action->name(), tree->name(), value,
+                           tree_value );
+      verify = false;
+      return tree_value;
+    }
+
+    return value;
+  }
+};
+
+// Shared Expressions =======================================================
+
+// One occurrence of an actor-wide shared subexpression. Each occurrence keeps its own expression
+// tree, which is evaluated when the shared value is not current for the evaluating action.
+class shared_expr_t : public expr_t
+{
+public:
+  shared_expr_entry_t* entry;
+  expr_t* input;
+  action_t* action;
+
+  shared_expr_t( shared_expr_entry_t* s, expr_t* e, action_t* a )
+    : expr_t( e->name(), e->op_ ), entry( s ), input( e ), action( a )
+  { }
+
+  ~shared_expr_t()
+  {
+    delete input;
+  }
+
+  expr_t* optimize( int spacing ) override
+  {
+    input = input->optimize( spacing );
+    return this;
+  }
+
+  bool is_constant( double* v ) override
+  {
+    return input->is_constant( v );
+  }
+
+  bool dependencies( expr_deps_t& deps ) const override
+  {
+    return input->dependencies( deps );
+  }
+
+  double evaluate() override  // override
+  {
+    const sim_t* sim = action->sim;
+    if ( entry->epoch == sim->state_epoch && entry->iteration == sim->current_iteration &&
+         entry->resource_version == action->player->resources.version &&
+         ( !entry->target_dependent || entry->target == action->target ) )
+    {
+      return entry->value;
+    }
+
+    entry->value            = input->eval();
+    entry->epoch            = sim->state_epoch;
+    entry->iteration        = sim->current_iteration;
+    entry->resource_version = action->player->resources.version;
+    entry->target           = action->target;
+
+    return entry->value;
+  }
+};
+
+// Classify an expression token for sharing across the action lists of an actor. Returns false for
+// tokens whose value depends on the action evaluating them (or on APL variables, which change
+// during an APL pass). Target dependent tokens are shared only between actions with the same
+// target.
+bool shareable_token( const action_t* action, const std::string& token, bool& target_dependent )
+{
+  std::string::size_type dot = token.find( '.' );
+  std::string prefix = token.substr( 0, dot );
+
+  if ( token.find( "variable." ) != std::string::npos || token.find( "action." ) != std::string::npos )
+    return false;
+
+  if ( dot == std::string::npos )
+  {
+    target_dependent = false;
+    return prefix == "time" || prefix == "active_enemies" ||
+           util::parse_resource_type( prefix ) != RESOURCE_NONE;
+  }
+
+  if ( prefix == "buff" || prefix == "debuff" || prefix == "dot" || prefix == "target" ||
+       ( prefix == "spell_targets" && !action->sim->distance_targeting_enabled ) )
+  {
+    target_dependent = true;
+    return true;
+  }
+
+  target_dependent = false;
+  return prefix == "talent" || prefix == "set_bonus" || prefix == "equipped" || prefix == "race" ||
+         prefix == "cooldown" || prefix == "raid_event" || prefix == "movement" || prefix == "prev" ||
+         prefix == "prev_gcd" || prefix == "prev_off_gcd" || prefix == "artifact" ||
+         prefix == "active_dot" || util::parse_resource_type( prefix ) != RESOURCE_NONE;
+}
+
+// Wrap expression e, with canonical form key, as an occurrence of a shared subexpression of the
+// actor
+expr_t* make_shared_expr( action_t* action, const std::string& key, bool target_dependent,
+                          expr_t* e )
+{
+  double v;
+  if ( e->is_constant( &v ) )
+    return e;
+
+  auto& entry = action->player->shared_expressions[ key ];
+  if ( !entry )
+    entry.reset( new shared_expr_entry_t( target_dependent ) );
+
+  return new shared_expr_t( entry.get(), e, action );
+}
+
+// Count the occurrences of shared subexpressions that remain in an (optimized) expression tree
+void count_shared_subtrees( expr_t* e )
+{
+  if ( shared_expr_t* s = dynamic_cast<shared_expr_t*>( e ) )
+  {
+    s->entry->uses++;
+    count_shared_subtrees( s->input );
+  }
+  else if ( binary_base_t* b = dynamic_cast<binary_base_t*>( e ) )
+  {
+    count_shared_subtrees( b->left );
+    count_shared_subtrees( b->right );
+  }
+  else if ( unary_base_t* u = dynamic_cast<unary_base_t*>( e ) )
+  {
+    count_shared_subtrees( u->input );
+  }
+  else if ( reduced_binary_base_t* r = dynamic_cast<reduced_binary_base_t*>( e ) )
+  {
+    count_shared_subtrees( r->operand );
+  }
+}
+
+// Remove the wrappers of subexpressions that occur only once (or have been folded into constants)
+// in the actor's action lists, and count the occurrences that remain shared. Occurrences must have
+// been counted with count_shared_subtrees() over all of the actor's optimized expressions first.
+expr_t* share_subtrees( expr_t* e )
+{
+  if ( shared_expr_t* s = dynamic_cast<shared_expr_t*>( e ) )
+  {
+    double v;
+    if ( s->entry->uses < 2 || s->input->is_constant( &v ) )
+    {
+      expr_t* input = s->input;
+      s->input      = nullptr;
+      delete s;
+      return share_subtrees( input );
+    }
+
+    s->entry->kept++;
+    s->input = share_subtrees( s->input );
+    return s;
+  }
+
+  if ( binary_base_t* b = dynamic_cast<binary_base_t*>( e ) )
+  {
+    b->left  = share_subtrees( b->left );
+    b->right = share_subtrees( b->right );
+  }
+  else if ( unary_base_t* u = dynamic_cast<unary_base_t*>( e ) )
+  {
+    u->input = share_subtrees( u->input );
+  }
+  else if ( reduced_binary_base_t* r = dynamic_cast<reduced_binary_base_t*>( e ) )
+  {
+    r->operand = share_subtrees( r->operand );
+  }
+
+  return e;
+}
+
+// Cached Expressions =======================================================
+
+// Caches the value of an expression with known dependencies. The expression is re-evaluated only
+// when a dependency changes, when the simulation time advances (for time dependent expressions),
+// or on a new iteration.
+class cached_expr_t : public expr_t
+{
+  const sim_t* sim;
+  expr_t* expr;
+  std::vector<const uint64_t*> versions;
+  std::vector<uint64_t> cached_versions;
+  bool time;
+  bool valid;
+  int cached_iteration;
+  timespan_t cached_time;
+  double value;
+
+public:
+  cached_expr_t( const sim_t* s, expr_t* e, expr_deps_t& deps )
+    : expr_t( e->name(), e->op_ ),
+      sim( s ),
+      expr( e ),
+      time( deps.time ),
+      valid( false ),
+      cached_iteration( 0 ),
+      cached_time( timespan_t::zero() ),
+      value( 0 )
+  {
+    range::sort( deps.versions );
+    versions.assign( deps.versions.begin(), range::unique( deps.versions ) );
+    cached_versions.resize( versions.size() );
+  }
+
+  ~cached_expr_t()
+  {
+    delete expr;
+  }
+
+  bool dependencies( expr_deps_t& deps ) const override
+  {
+    return expr->dependencies( deps );
+  }
+
+  double evaluate() override  // override
+  {
+    bool current = valid && cached_iteration == sim->current_iteration &&
+                   ( !time || cached_time == sim->current_time() );
+
+    for ( size_t i = 0, end = versions.size(); current && i < end; ++i )
+    {
+      current = *versions[ i ] == cached_versions[ i ];
+    }
+
+    if ( current )
+      return value;
+
+    // Snapshot the dependencies before evaluation, so any changes made during evaluation invalidate
+    // the cached value
+    for ( size_t i = 0, end = versions.size(); i < end; ++i )
+    {
+      cached_versions[ i ] = *versions[ i ];
+    }
+
+    cached_iteration = sim->current_iteration;
+    cached_time      = sim->current_time();
+    valid            = true;
+    value            = expr->eval();
+
+    return value;
+  }
+};
+
+// Replace the largest operator subtrees with known dependencies with cached expressions. Leaves are
+// cheap enough to evaluate on their own.
+expr_t* cache_subtrees( const sim_t* sim, expr_t* e, unsigned& n_cached )
+{
+  binary_base_t* b         = dynamic_cast<binary_base_t*>( e );
+  unary_base_t* u          = dynamic_cast<unary_base_t*>( e );
+  reduced_binary_base_t* r = dynamic_cast<reduced_binary_base_t*>( e );
+
+  // Shared subexpressions are evaluated at most once per state change already, but their private
+  // trees may still contain cacheable subtrees
+  if ( shared_expr_t* s = dynamic_cast<shared_expr_t*>( e ) )
+  {
+    s->input = cache_subtrees( sim, s->input, n_cached );
+    return e;
+  }
+
+  if ( !b && !u && !r )
+    return e;
+
+  expr_deps_t deps;
+  if ( e->dependencies( deps ) )
+  {
+    n_cached++;
+    return new cached_expr_t( sim, e, deps );
+  }
+
+  if ( b )
+  {
+    b->left  = cache_subtrees( sim, b->left, n_cached );
+    b->right = cache_subtrees( sim, b->right, n_cached );
+  }
+  else if ( u )
+  {
+    u->input = cache_subtrees( sim, u->input, n_cached );
+  }
+  else
+  {
+    r->operand = cache_subtrees( sim, r->operand, n_cached );
+  }
+
+  return e;
+}
+
 }  // UNNAMED NAMESPACE ====================================================
 
 // precedence ===============================================================
@@ -1182,6 +1946,9 @@ int expr_t::get_global_id()
 }
 #endif
 
+// Process-wide cache of expression strings converted to RPN token lists
+static cache::memo_t<std::string, std::vector<expression::expr_token_t>> rpn_cache;
+
 // build_expression_tree ====================================================
 
 static expr_t* build_expression_tree(
@@ -1190,6 +1957,16 @@ static expr_t* build_expression_tree(
 {
   auto_dispose<std::vector<expr_t*>> stack;
 
+  // Canonical forms of the subexpressions on the stack, for sharing them across the action lists of
+  // the actor. An empty key marks a subexpression that cannot be shared.
+  bool share = action->sim->share_expressions;
+  struct shared_key_t
+  {
+    std::string key;
+    bool target_dependent;
+  };
+  std::vector<shared_key_t> keys;
+
   size_t num_tokens = tokens.size();
   for ( size_t i = 0; i < num_tokens; i++ )
   {
@@ -1198,6 +1975,8 @@ static expr_t* build_expression_tree(
     if ( t.type == expression::TOK_NUM )
     {
       stack.push_back( new const_expr_t( t.label, atof( t.label.c_str() ) ) );
+      if ( share )
+        keys.push_back( shared_key_t{ t.label, false } );
     }
     else if ( t.type == expression::TOK_STR )
     {
@@ -1209,6 +1988,18 @@ static expr_t* build_expression_tree(
             action->player->name(), action->name(), t.label.c_str() );
         return nullptr;
       }
+
+      if ( share )
+      {
+        shared_key_t k{ std::string(), false };
+        if ( expression::shareable_token( action, t.label, k.target_dependent ) )
+        {
+          k.key = t.label;
+          e     = expression::make_shared_expr( action, k.key, k.target_dependent, e );
+        }
+        keys.push_back( k );
+      }
+
       stack.push_back( e );
     }
     else if ( expression::is_unary( t.type ) )
@@ -1222,6 +2013,17 @@ static expr_t* build_expression_tree(
           ( optimize
                 ? expression::select_analyze_unary( t.label, t.type, input )
                 : expression::select_unary( t.label, t.type, input ) );
+
+      if ( share )
+      {
+        shared_key_t& k = keys.back();
+        if ( !k.key.empty() )
+        {
+          k.key = t.label + "(" + k.key + ")";
+          expr  = expression::make_shared_expr( action, k.key, k.target_dependent, expr );
+        }
+      }
+
       stack.push_back( expr );
     }
     else if ( expression::is_binary( t.type ) )
@@ -1238,6 +2040,24 @@ static expr_t* build_expression_tree(
                                       t.label, t.type, left, right )
                                 : expression::select_binary( t.label, t.type,
                                                              left, right ) );
+
+      if ( share )
+      {
+        shared_key_t r = keys.back();
+        keys.pop_back();
+        shared_key_t& l = keys.back();
+        if ( !l.key.empty() && !r.key.empty() )
+        {
+          l.key              = "(" + l.key + t.label + r.key + ")";
+          l.target_dependent = l.target_dependent || r.target_dependent;
+          expr = expression::make_shared_expr( action, l.key, l.target_dependent, expr );
+        }
+        else
+        {
+          l.key.clear();
+        }
+      }
+
       stack.push_back( expr );
     }
   }
@@ -1260,28 +2080,41 @@ expr_t* expr_t::parse( action_t* action, const std::string& expr_str,
   if ( expr_str.empty() )
     return nullptr;
 
-  std::vector<expression::expr_token_t> tokens =
-      expression::parse_tokens( action, expr_str );
+  // The RPN form of an expression only depends on the expression string, so it is shared by all
+  // actors of all simulations. Debug mode always tokenizes to print the intermediate token lists.
+  std::vector<expression::expr_token_t> tokens;
+  if ( action->sim->debug || !rpn_cache.get( expr_str, tokens ) )
+  {
+    size_t n_errors = action->sim->error_list.size();
 
-  if ( action->sim->debug )
-    expression::print_tokens( tokens, action->sim );
+    tokens = expression::parse_tokens( action, expr_str );
 
-  expression::convert_to_unary( tokens );
+    if ( action->sim->debug )
+      expression::print_tokens( tokens, action->sim );
 
-  if ( action->sim->debug )
-    expression::print_tokens( tokens, action->sim );
+    expression::convert_to_unary( tokens );
 
-  if ( !expression::convert_to_rpn( tokens ) )
-  {
-    action->sim->errorf( "%s-%s: Unable to convert %s into RPN\n",
-                         action->player->name(), action->name(),
-                         expr_str.c_str() );
-    action->sim->cancel();
-    return nullptr;
-  }
+    if ( action->sim->debug )
+      expression::print_tokens( tokens, action->sim );
+
+    if ( !expression::convert_to_rpn( tokens ) )
+    {
+      action->sim->errorf( "%s-%s: Unable to convert %s into RPN\n",
+                           action->player->name(), action->name(),
+                           expr_str.c_str() );
+      action->sim->cancel();
+      return nullptr;
+    }
+
+    if ( action->sim->debug )
+      expression::print_tokens( tokens, action->sim );
 
-  if ( action->sim->debug )
-    expression::print_tokens( tokens, action->sim );
+    // Only cache cleanly tokenized expressions, so tokenizer errors are reported for every actor.
+    // Errors are only recorded by the main thread, so only it can tell.
+    if ( !action->sim->debug && action->sim->thread_index == 0 &&
+         action->sim->error_list.size() == n_errors )
+      rpn_cache.set( expr_str, tokens );
+  }
 
   if ( expr_t* e = build_expression_tree( action, tokens, optimize ) )
     return e;
@@ -1293,6 +2126,84 @@ expr_t* expr_t::parse( action_t* action, const std::string& expr_str,
   return nullptr;
 }
 
+// expr_t::compile ==========================================================
+
+expr_t* expr_t::compile( action_t* action, expr_t* expr )
+{
+  if ( !expr || action->sim->compile_expressions == 0 )
+    return expr;
+
+  // Constant expressions are already as cheap as they get, and must stay identifiable as constants
+  double v;
+  if ( expr->is_constant( &v ) )
+    return expr;
+
+  std::vector<expression::instruction_t> code;
+  expression::expr_compiler_t compiler( code );
+  compiler.emit( expr );
+
+  // Nothing to flatten
+  if ( code.size() == 1 && code[ 0 ].op == expression::OP_EXPR )
+    return expr;
+
+  if ( compiler.stack_size() > expression::MAX_COMPILED_STACK )
+  {
+    if ( action->sim->debug )
+      action->sim->out_debug.printf( "%s-%s: Expression '%s' is too deep to compile",
+                                     action->player->name(), action->name(), expr->name() );
+    return expr;
+  }
+
+  return new expression::compiled_expr_t( action, expr, code,
+                                          action->sim->compile_expressions > 1 );
+}
+
+// expr_t::cache ============================================================
+
+expr_t* expr_t::cache( action_t* action, expr_t* expr )
+{
+  if ( !expr || !action->sim->cache_expressions )
+    return expr;
+
+  unsigned n_cached = 0;
+  expr_t* e = expression::cache_subtrees( action->sim, expr, n_cached );
+
+  if ( action->sim->debug && n_cached > 0 )
+    action->sim->out_debug.printf( "%s-%s: Cached %u subexpressions of '%s'",
+                                   action->player->name(), action->name(), n_cached, expr->name() );
+
+  return e;
+}
+
+// expr_t::share ============================================================
+
+expr_t* expr_t::share( action_t* action, expr_t* expr )
+{
+  if ( !expr || !action->sim->share_expressions )
+    return expr;
+
+  return expression::share_subtrees( expr );
+}
+
+// expr_t::count_shared =====================================================
+
+void expr_t::count_shared( expr_t* expr )
+{
+  if ( expr )
+    expression::count_shared_subtrees( expr );
+}
+
+// make_dependent_expr ======================================================
+
+expr_t* make_dependent_expr( const sim_t& sim, expr_t* e,
+                             std::initializer_list<const uint64_t*> versions, bool time )
+{
+  if ( !e || !sim.cache_expressions )
+    return e;
+
+  return new dependent_expr_t( e, versions, time );
+}
+
 #ifdef UNIT_TEST
 
 uint32_t dbc::get_school_mask( school_e )
@@ -8,10 +8,15 @@
 #include <string>
 #include <vector>
 #include <functional>
+#include <initializer_list>
+#include <cstdint>
 
 #include "sc_timespan.hpp"
 
 struct action_t;
+struct buff_t;
+struct cooldown_t;
+struct dot_t;
 struct sim_t;
 struct player_t;
 
@@ -69,6 +74,86 @@ void convert_to_unary( std::vector<expr_token_t>& tokens );
 bool convert_to_rpn( std::vector<expr_token_t>& tokens );
 }
 
+/// Typed direct reference to the value read by a plain reference expression. Compiled expressions
+/// read the referenced value directly, instead of calling the expression's evaluate().
+struct expr_ref_t
+{
+  enum ref_e
+  {
+    REF_NONE = 0,
+    REF_DOUBLE,
+    REF_INT,
+    REF_UNSIGNED,
+    REF_BOOL,
+    REF_TIMESPAN,
+    // State references, ptr refers to the buff, cooldown or dot whose state is read
+    REF_BUFF_UP,
+    REF_BUFF_DOWN,
+    REF_BUFF_STACK,
+    REF_BUFF_REMAINS,
+    REF_COOLDOWN_UP,
+    REF_COOLDOWN_REMAINS,
+    REF_DOT_TICKING,
+    REF_DOT_REMAINS
+  };
+
+  ref_e type;
+  const void* ptr;
+
+  expr_ref_t() : type( REF_NONE ), ptr( nullptr )
+  { }
+
+  expr_ref_t( ref_e t, const void* p ) : type( t ), ptr( p )
+  { }
+
+  static expr_ref_t make( const double& v )
+  { return expr_ref_t( REF_DOUBLE, &v ); }
+  static expr_ref_t make( const int& v )
+  { return expr_ref_t( REF_INT, &v ); }
+  static expr_ref_t make( const unsigned& v )
+  { return expr_ref_t( REF_UNSIGNED, &v ); }
+  static expr_ref_t make( const bool& v )
+  { return expr_ref_t( REF_BOOL, &v ); }
+  static expr_ref_t make( const timespan_t& v )
+  { return expr_ref_t( REF_TIMESPAN, &v ); }
+  // Other types are evaluated through the expression
+  template <typename T>
+  static expr_ref_t make( const T& )
+  { return expr_ref_t(); }
+};
+
+/// State an expression value is computed from. Expressions that know their dependencies can have
+/// their values cached until one of the version counters changes, or the simulation time advances
+/// for time dependent expressions.
+struct expr_deps_t
+{
+  std::vector<const uint64_t*> versions;
+  bool time;
+
+  expr_deps_t() : time( false )
+  { }
+};
+
+/// Actor-wide shared subexpression. Every occurrence of the same subexpression in the action lists
+/// of an actor refers to one entry, which holds the value last computed for it. The value is reused
+/// within a simulation state epoch while the resources of the actor are unchanged (pool_resource
+/// evaluates lines with temporarily raised resources), and for target dependent subexpressions,
+/// only for the same target.
+struct shared_expr_entry_t
+{
+  bool target_dependent;
+  unsigned uses, kept;
+  int iteration;
+  uint64_t epoch, resource_version;
+  const player_t* target;
+  double value;
+
+  shared_expr_entry_t( bool td ) :
+    target_dependent( td ), uses( 0 ), kept( 0 ), iteration( -1 ), epoch( 0 ),
+    resource_version( 0 ), target( nullptr ), value( 0 )
+  { }
+};
+
 /// Action expression
 struct expr_t
 {
@@ -139,6 +224,10 @@ public:
                         bool optimize = false );
   template<class T>
   static expr_t* create_constant( const std::string& name, T value );
+  static expr_t* compile( action_t*, expr_t* expr );
+  static expr_t* cache( action_t*, expr_t* expr );
+  static expr_t* share( action_t*, expr_t* expr );
+  static void count_shared( expr_t* expr );
 
   virtual expr_t* optimize( int /* spacing */ = 0 )
   { /* spacing = 0; */
@@ -151,6 +240,17 @@ public:
     return false;
   }
 
+  virtual expr_ref_t reference() const
+  {
+    return expr_ref_t();
+  }
+
+  /// Collect the state this expression depends on. Returns false if the dependencies are unknown.
+  virtual bool dependencies( expr_deps_t& ) const
+  {
+    return false;
+  }
+
   expression::token_e op_;
 
 private:
@@ -182,6 +282,11 @@ public:
     *v = value;
     return true;
   }
+
+  bool dependencies( expr_deps_t& ) const override
+  {
+    return true;
+  }
 };
 
 // Reference Expression - ref_expr_t
@@ -195,6 +300,11 @@ public:
   {
   }
 
+  expr_ref_t reference() const override
+  {
+    return expr_ref_t::make( t );
+  }
+
 private:
   const T& t;
   virtual double evaluate() override
@@ -230,6 +340,54 @@ private:
   }
 };
 
+namespace expression
+{
+// State accessors for state expressions, specialized for each state reference type
+template <expr_ref_t::ref_e R, typename T>
+double state_value( const T& );
+
+template <> double state_value<expr_ref_t::REF_BUFF_UP>( const buff_t& );
+template <> double state_value<expr_ref_t::REF_BUFF_DOWN>( const buff_t& );
+template <> double state_value<expr_ref_t::REF_BUFF_STACK>( const buff_t& );
+template <> double state_value<expr_ref_t::REF_BUFF_REMAINS>( const buff_t& );
+template <> double state_value<expr_ref_t::REF_COOLDOWN_UP>( const cooldown_t& );
+template <> double state_value<expr_ref_t::REF_COOLDOWN_REMAINS>( const cooldown_t& );
+template <> double state_value<expr_ref_t::REF_DOT_TICKING>( const dot_t& );
+template <> double state_value<expr_ref_t::REF_DOT_REMAINS>( const dot_t& );
+}
+
+// State Expression - state_expr_t
+// Class Template to create an expression that reads a common piece of state ( R ) of a fixed buff,
+// cooldown or dot t. The accessor is bound at compile time, and compiled expressions evaluate the
+// state inline through the reference, instead of calling the expression's evaluate().
+template <expr_ref_t::ref_e R, typename T>
+struct state_expr_t : public expr_t
+{
+public:
+  state_expr_t( const std::string& name, const T& t_ ) : expr_t( name ), t( t_ )
+  {
+  }
+
+  expr_ref_t reference() const override
+  {
+    return expr_ref_t( R, &t );
+  }
+
+private:
+  const T& t;
+  virtual double evaluate() override
+  {
+    return expression::state_value<R>( t );
+  }
+};
+
+// Template to return a state expression
+template <expr_ref_t::ref_e R, typename T>
+inline expr_t* make_state_expr( const std::string& name, const T& t )
+{
+  return new state_expr_t<R, T>( name, t );
+}
+
 struct target_wrapper_expr_t : public expr_t
 {
   action_t& action;
@@ -248,6 +406,48 @@ struct target_wrapper_expr_t : public expr_t
   }
 };
 
+// Dependent Expression - dependent_expr_t
+// Declares the dependencies of an arbitrary expression, whose value is computed solely from the
+// given version counted state (and optionally the simulation time).
+struct dependent_expr_t : public expr_t
+{
+  expr_t* expr;
+  expr_deps_t deps;
+
+  dependent_expr_t( expr_t* e, std::initializer_list<const uint64_t*> versions, bool time )
+    : expr_t( e->name(), e->op_ ), expr( e )
+  {
+    deps.versions.assign( versions.begin(), versions.end() );
+    deps.time = time;
+  }
+
+  ~dependent_expr_t()
+  {
+    delete expr;
+  }
+
+  double evaluate() override
+  {
+    return expr->eval();
+  }
+
+  expr_ref_t reference() const override
+  {
+    return expr->reference();
+  }
+
+  bool dependencies( expr_deps_t& d ) const override
+  {
+    d.versions.insert( d.versions.end(), deps.versions.begin(), deps.versions.end() );
+    d.time = d.time || deps.time;
+    return true;
+  }
+};
+
+// Declare dependencies for expression e. Returns e as is, if expression caching is disabled.
+expr_t* make_dependent_expr( const sim_t& sim, expr_t* e,
+                             std::initializer_list<const uint64_t*> versions, bool time );
+
 // Template to return a function expression
 template <typename F>
 inline expr_t* make_fn_expr( const std::string& name, F&& f )
@@ -922,7 +922,8 @@ void option_db_t::parse_args( const std::vector<std::string>& args )
   #endif
 #endif
 
-option_db_t::option_db_t()
+option_db_t::option_db_t() :
+  base_index( 0 )
 {
   const char* paths[] = { "./profiles", "../profiles", SC_SHARED_DATA };
   int n_paths = 2;
@@ -85,11 +85,36 @@ struct option_db_t : public std::vector<option_tuple_t>
   std::vector<std::string> auto_path;
   std::unordered_map<std::string, std::string> var_map;
 
+  // Optional shared, immutable base options. When set, the effective option list is the base with
+  // the options of this database spliced in before base option at base_index. Allows a large number
+  // of option sets (e.g., profilesets) to share a single copy of the base profile.
+  std::shared_ptr<const option_db_t> base;
+  size_t base_index;
+
   option_db_t();
   void add( const std::string& scope, const std::string& name, const std::string& value )
   {
     push_back( option_tuple_t( scope, name, value ) );
   }
+  void set_base( const std::shared_ptr<const option_db_t>& b, size_t index )
+  {
+    base = b;
+    base_index = index;
+  }
+  // Number of effective options, including the base
+  size_t n_options() const
+  { return size() + ( base ? base -> n_options() : 0 ); }
+  // Effective option at index, including the base
+  const option_tuple_t& option( size_t index ) const
+  {
+    if ( ! base )
+      return operator[]( index );
+    if ( index < base_index )
+      return base -> option( index );
+    if ( index < base_index + size() )
+      return operator[]( index - base_index );
+    return base -> option( index - size() );
+  }
   bool parse_file( FILE* file );
   void parse_token( const std::string& token );
   void parse_line( const std::string& line );
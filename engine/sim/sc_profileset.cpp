@@ -4,6 +4,7 @@
 // ==========================================================================
 
 #include <future>
+#include <atomic>
 
 #include "simulationcraft.hpp"
 #include "sc_profileset.hpp"
@@ -67,22 +68,23 @@ bool in_player_scope( const option_tuple_t& opt )
   } ) != player_scope_opts.end();
 }
 
-sim_control_t* profilesets_t::create_sim_options( const sim_control_t*            original,
-                                                  const std::vector<std::string>& opts )
+sim_control_t* profilesets_t::create_sim_options( const std::shared_ptr<const option_db_t>& original,
+                                                  const std::vector<std::string>&           opts )
 {
   if ( original == nullptr )
   {
     return nullptr;
   }
 
-  sim_control_t new_options;
+  auto new_options = new sim_control_t();
 
   try
   {
-    new_options.options.parse_args( opts );
+    new_options -> options.parse_args( opts );
   }
   catch ( const std::exception& e ) {
     std::cerr << "ERROR! Incorrect option format: " << e.what() << std::endl;
+    delete new_options;
     return nullptr;
   }
 
@@ -92,48 +94,40 @@ sim_control_t* profilesets_t::create_sim_options( const sim_control_t*
   {
     // Find a suitable player-scope variable to start looking for an "enemy" option. "spec" option
     // must be always defined, so we can start the search below from it.
-    auto it = range::find_if( original -> options, []( const option_tuple_t& opt ) {
+    auto it = range::find_if( *original, []( const option_tuple_t& opt ) {
       return in_player_scope( opt );
     } );
 
-    if ( it == original -> options.end() )
+    if ( it == original -> end() )
     {
       std::cerr << "ERROR! No start of player-scope defined for the simulation" << std::endl;
+      delete new_options;
       return nullptr;
     }
 
     // Then, find the first enemy= line from the original options. The profileset options need to be
     // inserted after the original player definition, but before any enemy options are defined.
-    auto enemy_it = std::find_if( it, original -> options.end(), []( const option_tuple_t& opt ) {
+    auto enemy_it = std::find_if( it, original -> end(), []( const option_tuple_t& opt ) {
       return util::str_compare_ci( opt.name, "enemy" );
     } );
 
-    if ( enemy_it == original -> options.end() )
+    if ( enemy_it == original -> end() )
     {
       m_insert_index = 0;
     }
     else
     {
-      m_insert_index = std::distance( original -> options.begin(), enemy_it );
+      m_insert_index = std::distance( original -> begin(), enemy_it );
     }
   }
 
-  auto options_copy = new sim_control_t( *original );
+  // The profileset options are an overlay on top of the shared original options. No enemy option
+  // defined, overlay profileset options to the end of the original options. Enemy option found,
+  // overlay profileset options just before the enemy option.
+  new_options -> options.set_base( original,
+      m_insert_index == 0 ? original -> size() : as<size_t>( m_insert_index ) );
 
-  // No enemy option defined, insert profileset to the end of the original options
-  if ( m_insert_index == 0 )
-  {
-    options_copy -> options.insert( options_copy -> options.end(),
-                                    new_options.options.begin(), new_options.options.end() );
-  }
-  // Enemy option found, insert profileset options just before the enemy option
-  else
-  {
-    options_copy -> options.insert( options_copy -> options.begin() + m_insert_index,
-                                    new_options.options.begin(), new_options.options.end() );
-  }
-
-  return options_copy;
+  return new_options;
 }
 
 profile_set_t::profile_set_t( const std::string& name, sim_control_t* opts, bool has_output ) :
@@ -162,6 +156,98 @@ bool profilesets_t::validate( sim_t* ps_sim )
   return true;
 }
 
+// Test that profileset options are OK, up to the simulation initialization
+bool profilesets_t::test_profileset( const profile_set_t* set ) const
+{
+  try
+  {
+    auto test_sim = new sim_t();
+    test_sim -> profileset_enabled = true;
+
+    test_sim -> setup( set -> options() );
+    auto ret = test_sim -> init();
+
+    delete test_sim;
+
+    return ret;
+  }
+  catch ( const std::exception& e )
+  {
+    std::cerr <<  "ERROR! Profileset '" << set -> name() << "' Setup failure: "
+              << e.what() << std::endl;
+    return false;
+  }
+}
+
+// Validate profilesets on profileset_init_threads threads. Validated profilesets are handed over to
+// the executor strictly in the user given order, as soon as all profilesets before them have been
+// validated.
+bool profilesets_t::validate_profilesets( sim_t* sim, std::vector<profileset_entry_t>& pending )
+{
+  enum validate_state { PENDING = 0, VALID, INVALID };
+
+  std::vector<validate_state> states( pending.size(), PENDING );
+  std::atomic<size_t> next_index( 0 );
+  size_t commit_index = 0;
+  bool failed = false;
+
+  auto worker = [ & ]() {
+    while ( true )
+    {
+      auto index = next_index++;
+
+      m_mutex.lock();
+      auto stop = index >= pending.size() || failed || sim -> canceled;
+      m_mutex.unlock();
+
+      if ( stop )
+      {
+        break;
+      }
+
+      auto ret = test_profileset( pending[ index ].get() );
+
+      m_mutex.lock();
+      states[ index ] = ret ? VALID : INVALID;
+      failed = failed || ! ret;
+
+      auto n_committed = commit_index;
+      while ( commit_index < pending.size() && states[ commit_index ] == VALID )
+      {
+        m_profilesets.push_back( std::move( pending[ commit_index++ ] ) );
+      }
+      n_committed = commit_index - n_committed;
+      m_mutex.unlock();
+
+      if ( n_committed > 0 )
+      {
+        m_control.notify_one();
+      }
+    }
+  };
+
+  int n_threads = sim -> profileset_init_threads;
+  if ( n_threads <= 0 )
+  {
+    n_threads = std::max( 1, sim -> threads );
+  }
+
+  n_threads = std::min( n_threads, as<int>( pending.size() ) );
+
+  std::vector<std::thread> threads;
+  for ( int i = 1; i < n_threads; ++i )
+  {
+    threads.push_back( std::thread( worker ) );
+  }
+
+  // The profileset initialization thread participates in the work too
+  worker();
+
+  range::for_each( threads, []( std::thread& t ) { t.join(); } );
+
+  return ! failed && ! sim -> canceled;
+}
+
 bool profilesets_t::parse( sim_t* sim )
 {
   if ( sim -> profileset_map.size() == 0 )
@@ -178,24 +264,25 @@ bool profilesets_t::parse( sim_t* sim )
 
   set_state( INITIALIZING );
 
-  // Generate a copy of the original control, and remove any and all profileset. options from it
-  m_original = std::unique_ptr<sim_control_t>( new sim_control_t() );
+  // Generate a copy of the original options, and remove any and all profileset. options from it
+  auto original = std::make_shared<option_db_t>();
 
-  // Copy non-profileset. options to use as a base option setup for each profileset
-  range::copy_if( sim -> control -> options, std::back_inserter( m_original -> options ),
+  // Copy non-profileset. options to use as a shared base option setup for each profileset
+  range::copy_if( sim -> control -> options, std::back_inserter( *original ),
     []( const option_tuple_t& opt ) {
     return ! util::str_in_str_ci( opt.name, "profileset." );
   } );
 
+  m_original = original;
+
+  // Option overlays are cheap to construct, and m_insert_index is computed on first use, so build
+  // all of them up front in the user given order
+  std::vector<profileset_entry_t> pending;
+  pending.reserve( sim -> profileset_map.size() );
+
   for ( auto it = sim -> profileset_map.begin(); it != sim -> profileset_map.end(); ++it )
   {
-    if ( sim -> canceled )
-    {
-      set_state( DONE );
-      return false;
-    }
-
-    auto control = create_sim_options( m_original.get(), it -> second );
+    auto control = create_sim_options( m_original, it -> second );
     if ( control == nullptr )
     {
       set_state( DONE );
@@ -209,40 +296,29 @@ bool profilesets_t::parse( sim_t* sim )
              opt.find( "json2", 0, opt.find( "=" ) ) != std::string::npos;
     } ) != it -> second.end();
 
-    //sim -> control = control;
-
-    // Test that profileset options are OK, up to the simulation initialization
-    try
-    {
-      //auto test_sim = new sim_t( sim );
-      auto test_sim = new sim_t();
-      test_sim -> profileset_enabled = true;
-
-      test_sim -> setup( control );
-      auto ret = test_sim -> init();
-      if ( ! ret || ! validate( test_sim ) )
-      {
-        //sim -> control = original_control;
-        delete test_sim;
-        set_state( DONE );
-        return false;
-      }
-
-      delete test_sim;
-    }
-    catch ( const std::exception& e )
-    {
-      std::cerr <<  "ERROR! Profileset '" << it -> first << "' Setup failure: "
-                << e.what() << std::endl;
-      set_state( DONE );
-      return false;
-    }
+    pending.push_back( std::unique_ptr<profile_set_t>(
+        new profile_set_t( it -> first, control, has_output_opts ) ) );
+  }
 
+  // Without validation, everything is handed to the executor immediately. Each profileset
+  // simulation verifies itself during its own initialization instead.
+  if ( ! sim -> profileset_validation )
+  {
     m_mutex.lock();
-    m_profilesets.push_back( std::unique_ptr<profile_set_t>(
-        new profile_set_t( it -> first, control, has_output_opts ) ) );
+    range::for_each( pending, [ this ]( profileset_entry_t& set ) {
+      m_profilesets.push_back( std::move( set ) );
+    } );
+    m_state = RUNNING;
     m_mutex.unlock();
-    m_control.notify_one();
+    m_control.notify_all();
+
+    return true;
+  }
+
+  if ( ! validate_profilesets( sim, pending ) )
+  {
+    set_state( DONE );
+    return false;
   }
 
   set_state( RUNNING );
@@ -300,8 +376,8 @@ bool profilesets_t::iterate( sim_t* parent )
       m_control.wait( m_control_lock );
     }
 
-    // Break out of iteration loop if all work has been done
-    if ( is_running() )
+    // Break out of iteration loop if all work has been done, or validation failed
+    if ( ! is_initializing() )
     {
       if ( m_work_index == m_profilesets.size() )
       {
@@ -583,6 +659,8 @@ void create_options( sim_t* sim )
     sim -> profileset_metric = metric;
     return true;
   } ) );
+  sim -> add_option( opt_int( "profileset_init_threads", sim -> profileset_init_threads ) );
+  sim -> add_option( opt_bool( "profileset_validation", sim -> profileset_validation ) );
 }
 
 statistical_data_t collect( const extended_sample_data_t& c )
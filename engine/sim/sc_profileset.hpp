@@ -6,6 +6,7 @@
 #define SC_PROFILESET_HH
 
 #include <vector>
+#include <memory>
 #include <string>
 #include <thread>
 #include <mutex>
@@ -17,6 +18,7 @@
 
 struct sim_t;
 struct sim_control_t;
+struct option_db_t;
 struct player_t;
 class extended_sample_data_t;
 
@@ -144,7 +146,7 @@ class profilesets_t
 
   state                          m_state;
   profileset_vector_t            m_profilesets;
-  std::unique_ptr<sim_control_t> m_original;
+  std::shared_ptr<const option_db_t> m_original;
   int64_t                        m_insert_index;
   size_t                         m_work_index;
   std::mutex                     m_mutex;
@@ -152,8 +154,6 @@ class profilesets_t
   std::condition_variable        m_control;
   std::thread                    m_thread;
 
-  bool validate( sim_t* sim );
-
   int max_name_length() const;
 
   bool generate_chart( const sim_t& sim, io::ofstream& out ) const;
@@ -161,7 +161,11 @@ class profilesets_t
 
   void set_state( state new_state );
 
-  sim_control_t* create_sim_options( const sim_control_t*, const std::vector<std::string>& opts );
+  sim_control_t* create_sim_options( const std::shared_ptr<const option_db_t>&,
+                                    const std::vector<std::string>& opts );
+
+  bool test_profileset( const profile_set_t* set ) const;
+  bool validate_profilesets( sim_t* sim, std::vector<profileset_entry_t>& pending );
 public:
   profilesets_t() : m_state( STARTED ), m_original( nullptr ), m_insert_index( -1 ),
     m_work_index( 0 ), m_control_lock( m_mutex, std::defer_lock )
@@ -175,6 +179,8 @@ public:
     }
   }
 
+  static bool validate( sim_t* sim );
+
   size_t n_profilesets() const
   { return m_profilesets.size(); }
 
@@ -192,17 +192,6 @@ struct adds_event_t : public raid_event_t
     }
   }
 
-  void regenerate_cache()
-  {
-    for (auto p : affected_players)
-    {
-      
-      // Invalidate target caches
-      for ( size_t i = 0, end = p -> action_list.size(); i < end; i++ )
-        p -> action_list[i] -> target_cache.is_valid = false; //Regenerate Cache.
-    }
-  }
-
   void _start() override
   {
     adds_to_remove = static_cast<size_t>( util::round( std::max( 0.0, sim -> rng().range( count - count_range, count + count_range ) ) ) );
@@ -230,8 +219,7 @@ struct adds_event_t : public raid_event_t
         }
 
         adds[i] -> summon( saved_duration );
-        adds[i] -> x_position = x_offset + spawn_x_coord;
-        adds[i] -> y_position = y_offset + spawn_y_coord;
+        adds[i] -> set_position( x_offset + spawn_x_coord, y_offset + spawn_y_coord );
 
         if ( sim -> log )
         {
@@ -246,7 +234,6 @@ struct adds_event_t : public raid_event_t
         adds[i] -> dismiss();
       }
     }
-    regenerate_cache();
   }
 
   void _finish() override
@@ -285,25 +272,13 @@ struct move_enemy_t : public raid_event_t
     }
   }
 
-  void regenerate_cache()
-  {
-    for (auto p : affected_players)
-    {
-      
-      // Invalidate target caches
-      for ( size_t i = 0, end = p -> action_list.size(); i < end; i++ )
-        p -> action_list[i] -> target_cache.is_valid = false; //Regenerate Cache.
-    }
-  }
-
   void reset() override
   {
     raid_event_t::reset();
 
     if ( enemy )
     {
-      enemy -> x_position = enemy -> default_x_position;
-      enemy -> y_position = enemy -> default_y_position;
+      enemy -> set_position( enemy -> default_x_position, enemy -> default_y_position );
     }
   }
 
@@ -313,9 +288,7 @@ struct move_enemy_t : public raid_event_t
     {
       original_x = enemy -> x_position;
       original_y = enemy -> y_position;
-      enemy -> x_position = x_coord;
-      enemy -> y_position = y_coord;
-      regenerate_cache();
+      enemy -> set_position( x_coord, y_coord );
     }
   }
 
@@ -323,9 +296,7 @@ struct move_enemy_t : public raid_event_t
   {
     if ( enemy )
     {
-      enemy -> x_position = enemy -> default_x_position;
-      enemy -> y_position = enemy -> default_y_position;
-      regenerate_cache();
+      enemy -> set_position( enemy -> default_x_position, enemy -> default_y_position );
     }
   }
 };
@@ -668,8 +668,10 @@ bool parse_override_spell_data( sim_t*             sim,
                                        const std::string& /* name */,
                                        const std::string& value )
 {
-  // Register overrides only once, for the main thread
-  if ( sim -> parent )
+  // Register overrides only once, for the main thread. Profileset validation sims have no parent,
+  // but run concurrently on the profileset initialization threads, and the main simulation has
+  // already registered the overrides.
+  if ( sim -> parent || sim -> profileset_enabled )
   {
     return true;
   }
@@ -1334,6 +1336,7 @@ sim_t::sim_t( sim_t* p, int index ) :
   vary_combat_length( 0.0 ),
   current_iteration( -1 ),
   iterations( 0 ),
+  state_epoch( 0 ),
   canceled( 0 ),
   target_error( 0 ),
   current_error( 0 ),
@@ -1367,7 +1370,16 @@ sim_t::sim_t( sim_t* p, int index ) :
   travel_variance( 0 ), default_skill( 1.0 ), reaction_time( timespan_t::from_seconds( 0.5 ) ),
   regen_periodicity( timespan_t::from_seconds( 0.25 ) ),
   ignite_sampling_delta( timespan_t::from_seconds( 0.2 ) ),
-  fixed_time( false ), optimize_expressions( false ),
+  fixed_time( false ), optimize_expressions( false ), compile_expressions( 0 ),
+  cache_expressions( false ), skip_unready_actions( true ),
+  profile_apl( false ), lazy_variables( false ),
+  share_expressions( false ),
+  filter_proc_callbacks( 1 ),
+  reset_touched_only( false ),
+  verify_reset( false ),
+  lazy_buff_expiration( false ),
+  aoe_batch_snapshot( false ),
+  analytic_regen( false ),
   current_slot( -1 ),
   optimal_raid( 0 ), log( 0 ), debug_each( 0 ), save_profiles( 0 ), default_actions( 0 ),
   normalized_stat( STAT_NONE ),
@@ -1392,6 +1404,7 @@ sim_t::sim_t( sim_t* p, int index ) :
   fight_style( "Patchwerk" ), add_waves( 0 ), overrides( overrides_t() ),
   default_aura_delay( timespan_t::from_millis( 30 ) ),
   default_aura_delay_stddev( timespan_t::from_millis( 5 ) ),
+  actor_index( true ),
   progress_bar( *this ),
   scaling( new scaling_t( this ) ),
   plot( new plot_t( this ) ),
@@ -1419,6 +1432,7 @@ sim_t::sim_t( sim_t* p, int index ) :
   maximize_reporting( false ),
   apikey( get_api_key() ),
   distance_targeting_enabled( false ),
+  spatial_index(),
   enable_dps_healing( false ),
   scaling_normalized( 1.0 ),
   // Multi-Threading
@@ -1433,7 +1447,9 @@ sim_t::sim_t( sim_t* p, int index ) :
   disable_hotfixes( false ),
   display_bonus_ids( false ),
   profileset_metric( SCALE_METRIC_DPS ),
-  profileset_enabled( false )
+  profileset_enabled( false ),
+  profileset_init_threads( 1 ),
+  profileset_validation( true )
 {
   item_db_sources.assign( std::begin( default_item_db_sources ),
                           std::end( default_item_db_sources ) );
@@ -1619,8 +1635,7 @@ void sim_t::reset()
 
   analyze_number = 0;
 
-  for ( auto& buff : buff_list )
-    buff -> reset();
+  reset_touched( *this, buff_list, touched_buffs );
 
   for ( auto& target : target_list )
     target -> reset();
@@ -2444,6 +2459,10 @@ bool sim_t::init()
   // Initialize actors
   if ( ! init_actors() ) return false;
 
+  // Profileset simulations may only contain a single actor. Checked here so that profilesets run
+  // without a separate test simulation are also validated before any iterations are done.
+  if ( profileset_enabled && ! profileset::profilesets_t::validate( this ) ) return false;
+
   if ( report_precision < 0 ) report_precision = 2;
 
   simulation_length.reserve( std::min( iterations, 10000 ) );
@@ -2692,7 +2711,7 @@ void sim_t::merge( sim_t& other_sim )
 
   for ( auto & buff : buff_list )
   {
-    if ( buff_t* otherbuff = buff_t::find( &other_sim, buff -> name_str.c_str() ) )
+    if ( buff_t* otherbuff = buff_t::find( &other_sim, buff -> name_str ) )
     {
       buff -> merge( *otherbuff );
     }
@@ -2842,14 +2861,10 @@ player_t* sim_t::find_player( int index ) const
 
 cooldown_t* sim_t::get_cooldown( const std::string& name )
 {
-  cooldown_t* c;
+  cooldown_t* c = cooldown_index.find( cooldown_list, name );
 
-  for ( size_t i = 0; i < cooldown_list.size(); ++i )
-  {
-    c = cooldown_list[ i ];
-    if ( c -> name_str == name )
-      return c;
-  }
+  if ( c )
+    return c;
 
   c = new cooldown_t( name, *this );
 
@@ -2888,7 +2903,7 @@ expr_t* sim_t::create_expression( action_t* a,
     return expr_t::create_constant( name_str, target_list.size() );
 
   if ( name_str == "time" )
-    return make_ref_expr( name_str, event_mgr.current_time );
+    return make_dependent_expr( *this, make_ref_expr( name_str, event_mgr.current_time ), {}, true );
 
   if ( name_str == "channel_lag" )
     return expr_t::create_constant( name_str, channel_lag );
@@ -3077,6 +3092,18 @@ void sim_t::create_options()
   add_option( opt_int( "stat_cache", stat_cache ) );
   add_option( opt_int( "max_aoe_enemies", max_aoe_enemies ) );
   add_option( opt_bool( "optimize_expressions", optimize_expressions ) );
+  add_option( opt_int( "compile_expressions", compile_expressions, 0, 2 ) );
+  add_option( opt_bool( "cache_expressions", cache_expressions ) );
+  add_option( opt_bool( "skip_unready_actions", skip_unready_actions ) );
+  add_option( opt_bool( "profile_apl", profile_apl ) );
+  add_option( opt_bool( "lazy_variables", lazy_variables ) );
+  add_option( opt_bool( "share_expressions", share_expressions ) );
+  add_option( opt_int( "filter_proc_callbacks", filter_proc_callbacks, 0, 2 ) );
+  add_option( opt_bool( "reset_touched_only", reset_touched_only ) );
+  add_option( opt_bool( "verify_reset", verify_reset ) );
+  add_option( opt_bool( "lazy_buff_expiration", lazy_buff_expiration ) );
+  add_option( opt_bool( "aoe_batch_snapshot", aoe_batch_snapshot ) );
+  add_option( opt_bool( "analytic_regen", analytic_regen ) );
   add_option( opt_bool( "single_actor_batch", single_actor_batch ) );
   add_option( opt_bool( "progressbar_type", progressbar_type ) );
   // Raid buff overrides
@@ -3244,6 +3271,7 @@ void sim_t::create_options()
   add_option( opt_func( "maximize_reporting", parse_maximize_reporting ) );
   add_option( opt_string( "apikey", apikey ) );
   add_option( opt_bool( "distance_targeting_enabled", distance_targeting_enabled ) );
+  add_option( opt_float( "distance_targeting_cell_size", spatial_index.cell_size ) );
   add_option( opt_bool( "enable_dps_healing", enable_dps_healing ) );
   add_option( opt_float( "scaling_normalized", scaling_normalized ) );
   add_option( opt_int( "global_item_upgrade_level", global_item_upgrade_level ) );
@@ -3306,11 +3334,14 @@ void sim_t::setup( sim_control_t* c )
 
   control = c;
 
-  if ( ! parent ) cache::advance_era();
+  // The cache era is global state, advanced by the main simulation only (see
+  // parse_override_spell_data for profileset validation sims)
+  if ( ! parent && ! profileset_enabled ) cache::advance_era();
 
   // Global Options
-  for ( const auto& option : control -> options )
+  for ( size_t i = 0, end = control -> options.n_options(); i < end; i++ )
   {
+    const option_tuple_t& option = control -> options.option( i );
     if ( option.scope != "global" ) continue;
     if ( ! parse_option( option.name, option.value ) )
     {
@@ -3332,9 +3363,9 @@ void sim_t::setup( sim_control_t* c )
   }
 
   // Player Options
-  for ( size_t i = 0; i < control -> options.size(); i++ )
+  for ( size_t i = 0, end = control -> options.n_options(); i < end; i++ )
   {
-    option_tuple_t& o = control -> options[ i ];
+    const option_tuple_t& o = control -> options.option( i );
     if ( o.scope == "global" ) continue;
     player_t* p = find_player( o.scope );
     if ( !p )
@@ -49,6 +49,7 @@
 #include <type_traits>
 #include <unordered_map>
 #include <atomic>
+#include <chrono>
 #include <random>
 #if defined( SC_OSX )
 #include <Availability.h>
@@ -473,6 +474,77 @@ struct gear_stats_t
   static double stat_mod( stat_e stat );
 };
 
+// Name Index ===============================================================
+
+// Constant time name lookups over a list of named objects (anything with a name_str), keyed on the
+// object names. The index follows the list lazily: objects appended to the list since the previous
+// lookup are indexed on the next one, and any other change to the list (detected through its size
+// and last indexed object) rebuilds the index.
+template <typename T>
+class name_index_t
+{
+  mutable std::unordered_map<std::string, std::vector<T*>> index;
+  mutable size_t n_indexed;
+  mutable const T* last_indexed;
+  bool case_insensitive;
+
+  std::string key( const std::string& name ) const
+  {
+    if ( ! case_insensitive )
+      return name;
+
+    std::string lower = name;
+    util::tolower( lower );
+    return lower;
+  }
+
+  void update( const std::vector<T*>& list ) const
+  {
+    if ( list.size() < n_indexed || ( n_indexed > 0 && list[ n_indexed - 1 ] != last_indexed ) )
+    {
+      index.clear();
+      n_indexed = 0;
+    }
+
+    for ( ; n_indexed < list.size(); ++n_indexed )
+    {
+      index[ key( list[ n_indexed ] -> name_str ) ].push_back( list[ n_indexed ] );
+    }
+
+    last_indexed = n_indexed > 0 ? list[ n_indexed - 1 ] : nullptr;
+  }
+
+public:
+  name_index_t( bool ci = false ) :
+    n_indexed( 0 ), last_indexed( nullptr ), case_insensitive( ci )
+  { }
+
+  // First object of the list (in list order) with the given name, for which pred holds
+  template <typename Predicate>
+  T* find( const std::vector<T*>& list, const std::string& name, Predicate pred ) const
+  {
+    update( list );
+
+    auto it = case_insensitive ? index.find( key( name ) ) : index.find( name );
+    if ( it == index.end() )
+      return nullptr;
+
+    for ( T* obj : it -> second )
+    {
+      // Objects renamed after they were indexed are no longer found under their old name
+      bool same_name = case_insensitive ? util::str_compare_ci( obj -> name_str, name )
+                                        : obj -> name_str == name;
+      if ( same_name && pred( obj ) )
+        return obj;
+    }
+
+    return nullptr;
+  }
+
+  T* find( const std::vector<T*>& list, const std::string& name ) const
+  { return find( list, name, []( const T* ) { return true; } ); }
+};
+
 // Actor Pair ===============================================================
 
 struct actor_pair_t
@@ -834,6 +906,12 @@ public:
   // dynamic values
   double current_value;
   int current_stack;
+  // Incremented whenever stacks or duration of the buff change. Used to track expression dependencies.
+  uint64_t version;
+  // Registered on the touched buff list of the owner (player or sim) for the next iteration reset
+  bool touched;
+  // End time of a lazily expiring application (lazy_buff_expiration=1), timespan_t::min() if none
+  timespan_t lazy_expiration;
   timespan_t buff_duration;
   double default_chance;
   std::vector<timespan_t> stack_occurrence, stack_react_time;
@@ -890,6 +968,8 @@ public:
    */
   int check() const
   {
+    if ( lazy_expiration != timespan_t::min() )
+      resolve_lazy_expiration();
     return current_stack;
   }
 
@@ -925,7 +1005,8 @@ public:
    */
   double stack_value()
   {
-    return current_stack * value();
+    double v = value();
+    return current_stack * v;
   }
 
   /**
@@ -933,6 +1014,7 @@ public:
    */
   double check_value()
   {
+    check();
     return current_value;
   }
 
@@ -941,7 +1023,8 @@ public:
    */
   double check_stack_value()
   {
-    return current_stack * check_value();
+    double v = check_value();
+    return current_stack * v;
   }
 
   /**
@@ -977,6 +1060,10 @@ public:
   virtual void expire_override( int /* expiration_stacks */, timespan_t /* remaining_duration */ ) {}
   virtual void predict();
   virtual void reset();
+  // Register the buff for the next iteration reset on its first state change in an iteration
+  void touch();
+  // True if the buff is in the state reset() puts it in
+  bool is_reset() const;
   virtual void aura_gain();
   virtual void aura_loss();
   virtual void merge( const buff_t& other_buff );
@@ -1006,7 +1093,7 @@ public:
   static buff_t* find( const std::vector<buff_t*>&, const std::string& name, player_t* source = nullptr );
   static buff_t* find(    sim_t*, const std::string& name );
   static buff_t* find( player_t*, const std::string& name, player_t* source = nullptr );
-  static buff_t* find_expressable( const std::vector<buff_t*>&, const std::string& name, player_t* source = nullptr );
+  static buff_t* find_expressable( player_t*, const std::string& name, player_t* source = nullptr );
 
   const char* name() const { return name_str.c_str(); }
   std::string source_name() const;
@@ -1038,6 +1125,12 @@ public:
   buff_t* set_tick_time_behavior( buff_tick_time_e b )
   { tick_time_behavior = b; return this; }
 
+protected:
+  void bump_version();
+
+private:
+  bool lazy_expiration_eligible() const;
+  void resolve_lazy_expiration() const;
 };
 
 struct stat_buff_t : public buff_t
@@ -1517,6 +1610,7 @@ struct event_manager_t
   void recycle_event( event_t* );
   void add_event( event_t*, timespan_t delta_time );
   void reschedule_event( event_t* );
+  void adjust_event( event_t*, timespan_t delta_time );
   event_t* next_event();
   bool execute();
   void cancel();
@@ -1526,10 +1620,113 @@ struct event_manager_t
   void merge( event_manager_t& other );
 };
 
+// Action State Arena =======================================================
+
+/* Per-sim storage for action states. Each object size gets its own pool of chunks, so states of
+ * the same type live contiguously. Actions recycle their states through their own free lists
+ * ( action_t::state_cache ); states that are deleted go back to the free list of their pool, and
+ * all memory is released with the arena.
+ *
+ * action_t::get_state() makes the arena of the sim current for the thread while it creates a
+ * new state, see action_state_t::operator new. States created with no current arena come from
+ * the heap.
+ */
+struct state_arena_t : private noncopyable
+{
+  struct pool_t
+  {
+    std::size_t size;
+    void* free_list;
+    char* next;
+    char* end;
+
+    pool_t( std::size_t s ) : size( s ), free_list( nullptr ), next( nullptr ), end( nullptr )
+    { }
+  };
+
+  // Objects per chunk
+  static const std::size_t CHUNK_OBJECTS = 64;
+
+  state_arena_t() { }
+  ~state_arena_t();
+
+  // Allocate an object of size bytes, returns its pool in pool
+  void* allocate( std::size_t size, pool_t*& pool );
+  static void release( pool_t* pool, void* p );
+
+  // The current arena of the thread
+  static state_arena_t*& current();
+
+  // Make an arena the current arena of the thread for the lifetime of the scope object
+  struct scope_t
+  {
+    state_arena_t* previous;
+    scope_t( state_arena_t& arena ) : previous( current() ) { current() = &arena; }
+    ~scope_t() { current() = previous; }
+  };
+
+private:
+  std::vector<std::unique_ptr<pool_t>> pools;
+  std::vector<void*> chunks;
+};
+
+// Spatial Index ============================================================
+
+/* Uniform grid over the actor positions, used by distance targeting to find the actors near a
+ * point without measuring the distance to every actor. Actors are moved in the grid as their
+ * position changes ( player_t::set_position ), which also advances the version of the index.
+ *
+ * Range queries return the actors of all grid cells overlapping the query area, a superset of
+ * the actors in range, so callers still check the exact distance of the candidates. Query results
+ * are cached until the next position change.
+ */
+struct spatial_index_t : private noncopyable
+{
+  struct query_t
+  {
+    double x, y, radius;
+    std::vector<player_t*> actors;
+    std::vector<uint8_t> member; // Indexed by actor index
+
+    bool contains( const player_t* actor ) const;
+  };
+
+  // Grid cell size in yards, 0 disables the grid
+  double cell_size;
+  // Incremented on every position change of an actor
+  uint64_t version;
+  // Largest combat reach of the indexed actors
+  double max_combat_reach;
+
+  spatial_index_t();
+
+  bool active() const
+  { return cell_size > 0; }
+
+  void update( player_t* actor );
+  const query_t& query( double x, double y, double radius );
+
+private:
+  typedef int64_t cell_key_t;
+  static const cell_key_t NO_CELL = std::numeric_limits<cell_key_t>::min();
+
+  int cell( double coordinate ) const;
+  static cell_key_t key( int cx, int cy );
+  void add_cell( query_t& q, cell_key_t key ) const;
+
+  std::unordered_map<cell_key_t, std::vector<player_t*>> cells;
+  std::vector<cell_key_t> actor_cells; // Indexed by actor index
+  std::vector<std::unique_ptr<query_t>> queries;
+  uint64_t query_version;
+};
+
 // Simulation Engine ========================================================
 
 struct sim_t : private sc_thread_t
 {
+  // Action states of the actors live in the arena, so it has to outlive them
+  state_arena_t state_arena;
+
   event_manager_t event_mgr;
 
   // Output
@@ -1542,6 +1739,9 @@ struct sim_t : private sc_thread_t
   timespan_t max_time, expected_iteration_time;
   double vary_combat_length;
   int current_iteration, iterations;
+  // Incremented on every executed event and action. State derived from the APL (memoized target
+  // selection, shared expressions) is only reused within one epoch.
+  uint64_t state_epoch;
   bool canceled;
   double target_error;
   double current_error;
@@ -1582,6 +1782,25 @@ struct sim_t : private sc_thread_t
   timespan_t  reaction_time, regen_periodicity;
   timespan_t  ignite_sampling_delta;
   bool        fixed_time, optimize_expressions;
+  int         compile_expressions;
+  bool        cache_expressions;
+  bool        skip_unready_actions;
+  bool        profile_apl;
+  bool        lazy_variables;
+  bool        share_expressions;
+  // Trigger proc callbacks from pre-filtered per-action lists; 0 disabled, 1 enabled, 2 enabled and
+  // report the callback visits saved per actor
+  int         filter_proc_callbacks;
+  // Reset only the buffs and dots that changed state during an iteration (opt-in), optionally
+  // verifying that all the others are in their reset state
+  bool        reset_touched_only, verify_reset;
+  // Passive buffs expire at their end time on the next read, instead of through expiration events
+  bool        lazy_buff_expiration;
+  // Aoe actions snapshot the target independent part of their state once for all targets
+  bool        aoe_batch_snapshot;
+  // Dynamically regenerating resources are evaluated on read, instead of regenerated before every
+  // action
+  bool        analytic_regen;
   int         current_slot;
   int         optimal_raid, log, debug_each;
   std::vector<uint64_t> debug_seed;
@@ -1692,6 +1911,14 @@ struct sim_t : private sc_thread_t
 
   auto_dispose< std::vector<cooldown_t*> > cooldown_list;
 
+  // Sim buffs that changed state during the current iteration
+  std::vector<buff_t*> touched_buffs;
+
+  // Name lookup indices for buff_list, cooldown_list and (case insensitively) actor_list
+  name_index_t<buff_t> buff_index;
+  name_index_t<cooldown_t> cooldown_index;
+  name_index_t<player_t> actor_index;
+
   // Reporting
   progress_bar_t progress_bar;
   std::unique_ptr<scaling_t> scaling;
@@ -1755,6 +1982,7 @@ struct sim_t : private sc_thread_t
   bool maximize_reporting;
   std::string apikey;
   bool distance_targeting_enabled;
+  spatial_index_t spatial_index;
   bool enable_dps_healing;
   double scaling_normalized;
 
@@ -1880,6 +2108,8 @@ struct sim_t : private sc_thread_t
   profileset::profilesets_t profilesets;
   scale_metric_e profileset_metric;
   bool profileset_enabled;
+  int profileset_init_threads;
+  bool profileset_validation;
 
   sim_t( sim_t* parent = nullptr, int thread_index = 0 );
   virtual ~sim_t();
@@ -2179,7 +2409,11 @@ struct event_t : private noncopyable
 
   void schedule( timespan_t delta_time );
 
+  // Move the event later, lazily. The event is moved when it comes up in the timing wheel.
   void reschedule( timespan_t new_time );
+  // Move the event to occur delta_time from now, earlier or later, in place in the timing wheel.
+  // Ordered the same as a newly created event would be, without the cancel-and-recreate.
+  void adjust( timespan_t delta_time );
   sim_t& sim()
   { return _sim; }
   const sim_t& sim() const
@@ -3117,6 +3351,7 @@ struct cooldown_t
   double recharge_multiplier;
   bool hasted; // Hasted cooldowns will reschedule based on haste state changing (through buffs). TODO: Separate hastes?
   action_t* action; // Dynamic cooldowns will need to know what action triggered the cd
+  uint64_t version; // Incremented whenever the state of the cooldown changes. Used to track expression dependencies.
 
   cooldown_t( const std::string& name, player_t& );
   cooldown_t( const std::string& name, sim_t& );
@@ -3186,9 +3421,33 @@ struct effect_callbacks_t
 
   proc_array_t procs;
 
-  effect_callbacks_t( sim_t* sim ) : sim( sim )
+  // Incremented whenever a callback is registered, invalidating the pre-filtered per-action proc
+  // callback lists ( see action_t::trigger_proc_callbacks() )
+  unsigned version;
+
+  // Deduplicated storage for the pre-filtered per-action proc callback lists
+  std::vector<std::unique_ptr<proc_list_t>> filtered_lists;
+
+  // Callbacks visited and skipped by actions triggering through pre-filtered lists, collected with
+  // filter_proc_callbacks=2
+  uint64_t filtered_visits, filtered_skips;
+
+  effect_callbacks_t( sim_t* sim ) : sim( sim ), version( 0 ), filtered_visits( 0 ), filtered_skips( 0 )
   { }
 
+  const proc_list_t* filtered_list( const proc_list_t& list )
+  {
+    auto it = range::find_if( filtered_lists, [ &list ]( const std::unique_ptr<proc_list_t>& l ) {
+      return *l == list;
+    } );
+
+    if ( it != filtered_lists.end() )
+      return it -> get();
+
+    filtered_lists.push_back( std::unique_ptr<proc_list_t>( new proc_list_t( list ) ) );
+    return filtered_lists.back().get();
+  }
+
   bool has_callback( const std::function<bool(const T_CB*)> cmp ) const
   { return range::find_if( all_callbacks, cmp ) != all_callbacks.end(); }
 
@@ -3222,17 +3481,28 @@ private:
  * - Same goes for stat_buff_t, which works through player_t::stat_gain/loss
  * - Buffs with effects in a composite_ function need invalidates added to their buff_creator
  *
- * To create invalidation chains ( eg. Priest: Spirit invalidates Hit ) override the
- * virtual player_t::invalidate_cache( cache_e ) function.
+ * Invalidation chains ( eg. Strength invalidates Attack Power ) are declared as cache
+ * dependencies in player_t::init_cache_dependencies(), which class modules extend by overriding
+ * it and calling player_stat_cache_t::add_dependency(). The dependencies are compiled into one
+ * invalidation mask per cache at the end of actor initialization, so invalidating a stat and
+ * everything that depends on it clears a single mask from the 'valid'-states.
  *
- * Attention: player_t::invalidate_cache( cache_e ) is recursive and may call itself again.
+ * Chains that depend on runtime state ( eg. an active buff ), or invalidations that have side
+ * effects, still belong in an override of the virtual player_t::invalidate_cache( cache_e )
+ * function. Use player_stat_cache_t::invalidates() there to test if the invalidated cache
+ * affects a given cache.
  */
 struct player_stat_cache_t
 {
+  typedef std::bitset<CACHE_MAX> mask_t;
+
   const player_t* player;
-  mutable std::array<bool, CACHE_MAX> valid;
-  mutable std::array < bool, SCHOOL_MAX + 1 > spell_power_valid, player_mult_valid, player_heal_mult_valid;
   // 'valid'-states
+  mutable mask_t valid;
+  mutable std::bitset<SCHOOL_MAX + 1> spell_power_valid, player_mult_valid, player_heal_mult_valid;
+  // Direct dependents of each cache, and the compiled invalidation mask ( the cache and all its
+  // direct and indirect dependents ) of each cache
+  std::array<mask_t, CACHE_MAX> dependents, invalidation_mask;
 private:
   // cached values
   mutable double _strength, _agility, _stamina, _intellect, _spirit;
@@ -3249,10 +3519,21 @@ private:
   mutable double _leech, _run_speed, _avoidance;
 public:
   bool active; // runtime active-flag
+  bool compiled; // dependencies compiled into the invalidation masks
   void invalidate_all();
   void invalidate( cache_e );
+  void invalidate( const mask_t& );
+  void add_dependency( cache_e c, cache_e dependent );
+  void compile_dependencies();
+  bool invalidates( cache_e c, cache_e dependent ) const
+  { return invalidation_mask[ c ].test( dependent ); }
   double get_attribute( attribute_e ) const;
-  player_stat_cache_t( const player_t* p ) : player( p ), active( false ) { invalidate_all(); }
+  player_stat_cache_t( const player_t* p ) : player( p ), active( false ), compiled( false )
+  {
+    for ( size_t c = 0; c < CACHE_MAX; ++c )
+      invalidation_mask[ c ].set( c );
+    invalidate_all();
+  }
 #if defined(SC_USE_STAT_CACHE)
   // Cache stat functions
   double strength() const;
@@ -3666,16 +3947,35 @@ struct action_variable_t
 {
   std::string name_;
   double current_value_, default_;
+  // Incremented whenever the value of the variable changes. Used to track expression dependencies.
+  uint64_t version;
+
+  // Lazy evaluation (lazy_variables=1). Operations executed on the variable during the current APL
+  // pass are queued in walk order, and evaluated only when the value of the variable is read.
+  struct lazy_op_t
+  {
+    uint64_t seq;
+    action_t* action;
+    double value;
+    bool evaluated;
+  };
+  std::vector<lazy_op_t> lazy_ops;
+  // Value of the variable at the start of the APL pass
+  double lazy_base_value;
+  // Every read of the variable in an APL pass is preceded by an unconditional set of it, so
+  // operations left unread at the end of a pass never need to be evaluated
+  bool pass_scoped;
 
   action_variable_t( const std::string& name, double def = 0 ) :
-    name_( name ), current_value_( def ), default_( def )
+    name_( name ), current_value_( def ), default_( def ), version( 0 ),
+    lazy_base_value( def ), pass_scoped( false )
   { }
 
   double value() const
   { return current_value_; }
 
   void reset()
-  { current_value_ = default_; }
+  { current_value_ = default_; version++; }
 };
 
 struct scaling_metric_data_t {
@@ -3720,6 +4020,43 @@ struct player_scaling_t
   { scales_with[ stat ] = state; }
 };
 
+// DoT Tick Scheduler =======================================================
+
+// Periodic scheduler for the ticks of the dots an actor is the source of. When active, the pending
+// ticks are kept in a heap ordered by tick time, and a single event is scheduled for the earliest
+// of them, executing all ticks that fall on the same timestamp in the order they were scheduled.
+// Canceling or moving a tick only invalidates its heap entry. Haste driven tick time changes are
+// picked up when the next tick is scheduled, as with per-dot tick events.
+struct dot_tick_scheduler_t
+{
+  struct entry_t
+  {
+    timespan_t time;
+    uint64_t id;
+    dot_t* dot;
+  };
+
+  player_t* player;
+  bool active;
+  event_t* event;
+  uint64_t next_id;
+  std::vector<entry_t> heap;
+  std::vector<entry_t> batch;
+
+  dot_tick_scheduler_t( player_t* p ) :
+    player( p ), active( false ), event( nullptr ), next_id( 0 )
+  { }
+
+  void schedule( dot_t* d, timespan_t time_to_tick );
+  void cancel( dot_t* d );
+  void execute();
+  void reset();
+
+private:
+  static bool valid( const entry_t& e );
+  void schedule_event();
+};
+
 struct player_t : public actor_t
 {
   static const int default_level = 110;
@@ -3914,8 +4251,11 @@ struct player_t : public actor_t
         base_multiplier, initial_multiplier;
     std::array<int, RESOURCE_MAX> infinite_resource;
     std::array<bool, RESOURCE_MAX> active_resource;
+    // Incremented whenever current or maximum resources change outside of regeneration. Used to
+    // track expression dependencies.
+    uint64_t version;
 
-    resources_t()
+    resources_t() : version( 0 )
     {
       range::fill( base, 0.0 );
       range::fill( initial, 0.0 );
@@ -3959,6 +4299,7 @@ struct player_t : public actor_t
   action_t* last_foreground_action;
   std::vector<action_t*> prev_gcd_actions;
   std::vector<action_t*> off_gcdactions; // Returns all off gcd abilities used since the last gcd.
+  dot_tick_scheduler_t dot_tick_scheduler;
 
   // Delay time used by "cast_delay" expression to determine when an action
   // can be used at minimum after a spell cast has finished, including GCD
@@ -4014,6 +4355,24 @@ struct player_t : public actor_t
   std::array< std::vector<plot_data_t>, STAT_MAX > dps_plot_data;
   std::vector<std::vector<plot_data_t> > reforge_plot_data;
   auto_dispose< std::vector<luxurious_sample_data_t*> > sample_data_list;
+  // Buffs and dots that changed state during the current iteration, and need a reset before the next
+  std::vector<buff_t*> touched_buffs;
+  std::vector<dot_t*> touched_dots;
+
+  // Name lookup indices for the object lists of the actor
+  struct name_indices_t
+  {
+    name_index_t<action_t> action;
+    name_index_t<buff_t> buff;
+    name_index_t<cooldown_t> cooldown;
+    name_index_t<dot_t> dot;
+    name_index_t<stats_t> stats;
+    name_index_t<gain_t> gain;
+    name_index_t<proc_t> proc;
+    name_index_t<benefit_t> benefit;
+    name_index_t<uptime_t> uptime;
+    name_index_t<luxurious_sample_data_t> sample_data;
+  } name_index;
 
   // All Data collected during / end of combat
   player_collected_data_t collected_data;
@@ -4064,6 +4423,8 @@ struct player_t : public actor_t
   double base_movement_speed;
   double passive_modifier; // _PASSIVE_ movement speed modifiers
   double x_position, y_position, default_x_position, default_y_position;
+  // Move the actor, keeping the spatial index of the sim up to date
+  void set_position( double x, double y );
 
   struct buffs_t
   {
@@ -4428,6 +4789,10 @@ struct player_t : public actor_t
 
   // Stat Caching
   player_stat_cache_t cache;
+  // Incremented whenever a buff of the actor changes or one of its caches is invalidated. Used to
+  // detect changes to the inputs of batched aoe snapshots.
+  uint64_t snapshot_version;
+  virtual void init_cache_dependencies();
 #if defined(SC_USE_STAT_CACHE)
   virtual void invalidate_cache( cache_e c );
 #else
@@ -4452,6 +4817,9 @@ struct player_t : public actor_t
   virtual void demise();
   virtual timespan_t available() const { return timespan_t::from_seconds( 0.1 ); }
   virtual action_t* select_action( const action_priority_list_t& );
+  double variable_value( action_variable_t* );
+  void end_lazy_variable_pass();
+  void resolve_lazy_variables();
   virtual action_t* execute_action();
 
   virtual void   regen( timespan_t periodicity = timespan_t::from_seconds( 0.25 ) );
@@ -4459,6 +4827,10 @@ struct player_t : public actor_t
   virtual double resource_loss( resource_e resource_type, double amount, gain_t* g = nullptr, action_t* a = nullptr );
   virtual void   recalculate_resource_max( resource_e resource_type );
   virtual bool   resource_available( resource_e resource_type, double cost ) const;
+  // Current amount of the resource, including analytic regeneration since the last regeneration
+  double resource_current( resource_e resource_type ) const;
+  // Total regeneration rate of the resource per second between regeneration updates
+  virtual double resource_regen_per_second( resource_e resource_type ) const;
   void collect_resource_timeline_information();
   virtual resource_e primary_resource() const { return RESOURCE_NONE; }
   virtual role_e   primary_role() const;
@@ -4641,6 +5013,10 @@ struct player_t : public actor_t
   rng::rng_t& rng() { return sim -> rng(); }
   rng::rng_t& rng() const { return sim -> rng(); }
   auto_dispose<std::vector<action_variable_t*>> variables;
+  /// Incremented whenever an APL variable of this actor changes value
+  uint64_t variable_version;
+  /// Shared subexpressions of the actor's action lists, keyed by their canonical form
+  std::unordered_map<std::string, std::unique_ptr<shared_expr_entry_t>> shared_expressions;
   // Add 1ms of time to ensure that we finish this run. This is necessary due
   // to the millisecond accuracy in our timing system.
   virtual timespan_t time_to_move() const
@@ -4829,6 +5205,16 @@ public:
   // player_t::init().
   bool dynamic_regen_pets;
 
+  // Resources regenerate linearly in time between dynamic regeneration updates. Actors with
+  // periodic regeneration in regen() clear this in their constructor.
+  bool linear_regen;
+
+  // With analytic_regen=1, the resources of a dynamically regenerating actor are a linear function
+  // of the time since the last regeneration update, evaluated by resource_current(). Regeneration
+  // is only performed on resource changes, regeneration rate changes and action execution.
+  // Initialized in player_t::init().
+  bool analytic_regen;
+
   // Perform dynamic resource regeneration
   virtual void do_dynamic_regen();
 
@@ -4836,6 +5222,18 @@ public:
   // player_t::execute_action().
   uint64_t visited_apls_;
 
+  // Lazy APL variable evaluation state for the current APL pass (lazy_variables=1)
+  struct lazy_variables_t
+  {
+    bool active;
+    uint64_t seq, horizon;
+    std::vector<action_variable_t*> touched;
+    std::vector<double> values;
+
+    lazy_variables_t() : active( false ), seq( 0 ), horizon( std::numeric_limits<uint64_t>::max() )
+    { }
+  } lazy_variables;
+
   // Internal counter for action priority lists, used to set
   // action_priority_list_t::internal_id for lists.
   unsigned action_list_id_;
@@ -5234,10 +5632,17 @@ struct action_state_t : private noncopyable
   static void release( action_state_t*& s );
   static std::string flags_to_str( unsigned flags );
 
+  // States come from the current state arena of the thread if there is one, and from the heap
+  // otherwise
+  static void* operator new( std::size_t size );
+  static void operator delete( void* p );
+
   action_state_t( action_t*, player_t* );
   virtual ~action_state_t() {}
 
   virtual void copy_state( const action_state_t* );
+  // Copy the snapshot fields selected by flags ( snapshot_state_e )
+  void copy_snapshot( const action_state_t*, unsigned flags );
   virtual void initialize();
 
   virtual std::ostringstream& debug_str( std::ostringstream& debug_str );
@@ -5298,6 +5703,45 @@ struct action_state_t : private noncopyable
   virtual proc_types2 cast_proc_type2() const;
 };
 
+// APL Line Profile =========================================================
+
+// Per APL line evaluation statistics, collected by player_t::select_action when profile_apl=1.
+// A line evaluates in the order of 100ns, so it is timed with a monotonic clock with nanosecond
+// resolution, instead of the microsecond resolution of stopwatch_t.
+struct apl_profile_t
+{
+  typedef std::chrono::steady_clock profile_clock_t;
+
+  uint64_t evaluations, ready, fail_cooldown, fail_resource, fail_condition;
+  int64_t time_ns;
+  profile_clock_t::time_point start_;
+
+  apl_profile_t() :
+    evaluations( 0 ), ready( 0 ), fail_cooldown( 0 ), fail_resource( 0 ), fail_condition( 0 ),
+    time_ns( 0 )
+  { }
+
+  void start()
+  { start_ = profile_clock_t::now(); }
+
+  void stop()
+  { time_ns += std::chrono::duration_cast<std::chrono::nanoseconds>( profile_clock_t::now() - start_ ).count(); }
+
+  // Accumulated time in seconds
+  double time() const
+  { return time_ns / 1e9; }
+
+  void merge( const apl_profile_t& other )
+  {
+    evaluations += other.evaluations;
+    ready += other.ready;
+    fail_cooldown += other.fail_cooldown;
+    fail_resource += other.fail_resource;
+    fail_condition += other.fail_condition;
+    time_ns += other.time_ns;
+  }
+};
+
 // Action ===================================================================
 
 struct action_t : private noncopyable
@@ -5349,6 +5793,20 @@ public:
   /// enables/disables proc callback system on the action, like trinkets, enchants, rppm.
   bool callbacks;
 
+  /**
+   * Opt-in partial snapshot. When enabled, copying a state of the action only copies the snapshot
+   * fields in snapshot_flags and update_flags, instead of all of them. Only enable it for actions
+   * that never read other snapshot fields of their states.
+   */
+  bool partial_snapshot;
+
+  /**
+   * Allow aoe_batch_snapshot to snapshot the target independent part of the state once for all
+   * targets. Disable it for actions whose snapshot_state() override depends on the target or chain
+   * target of the state, rolls random numbers, or overwrites the state multipliers.
+   */
+  bool batch_snapshot;
+
   /// Whether or not the spell uses the yellow attack hit table.
   bool special;
 
@@ -5722,6 +6180,32 @@ public:
   cooldown_t line_cooldown;
   const action_priority_t* signature;
 
+  /// APL variables read by the expressions of the action, recorded when they are created
+  std::vector<const action_variable_t*> variable_reads;
+
+  /**
+   * @brief Set once action_t::ready() has been entered for this action.
+   *
+   * Actions that never reach the base ready() (class module overrides that
+   * do not call it) are not gated by the cooldown checks in it, and thus
+   * cannot be skipped by player_t::select_action based on
+   * earliest_ready_time(). Never set for actions with ready_ignores_cooldown.
+   */
+  bool ready_gated;
+
+  /**
+   * @brief The ready() override of the action can make it ready while its
+   * cooldown is down (e.g., monk Keg Smash with Secret Ingredients).
+   *
+   * Class modules must set this for such actions, so that
+   * player_t::select_action does not skip them based on
+   * earliest_ready_time().
+   */
+  bool ready_ignores_cooldown;
+
+  /// APL line profile, only collected when profile_apl=1
+  apl_profile_t apl_profile;
+
 
   /// State of the last execute()
   action_state_t* execute_state;
@@ -5733,6 +6217,10 @@ public:
 
   unsigned update_flags;
 
+  /// Snapshot fields copied by action_state_t::copy_state for states of this action, set up by
+  /// consolidate_snapshot_flags() from partial_snapshot.
+  unsigned state_copy_flags;
+
   /**
    * Target Cache System
    * - list: contains the cached target pointers
@@ -5744,9 +6232,49 @@ public:
   struct target_cache_t {
     std::vector< player_t* > list;
     bool is_valid;
-    target_cache_t() : is_valid( false ) {}
+    // Spatial index version the list was built for, distance targeting rebuilds the list when
+    // actors have moved since
+    uint64_t spatial_version;
+    target_cache_t() : is_valid( false ), spatial_version( 0 ) {}
   } mutable target_cache;
 
+  /**
+   * Proc callbacks of the actor, pre-filtered for this action with action_callback_t::can_trigger.
+   * One list per proc type pair, indexed by proc_types * PROC2_TYPE_MAX + proc_types2. Rebuilt
+   * when the callbacks of the actor, or the weapon of the action change.
+   */
+  struct proc_callbacks_t {
+    unsigned version;
+    const weapon_t* weapon;
+    std::vector<const std::vector<action_callback_t*>*> lists;
+    proc_callbacks_t() : version( 0 ), weapon( nullptr ) {}
+  } proc_callbacks;
+
+  /**
+   * Target selection memoization for target_if and cycle_targets. The result of the last
+   * selection is reused as long as the state it was computed in is unchanged: the same
+   * iteration, the same state epoch (no event or action has executed in between), the same set
+   * of APL variable values and resources for the actor (pool_resource evaluates lines with
+   * temporarily raised resources), and the same original target of the action.
+   *
+   * Selection is not memoized when evaluating it rolls for skill based false negatives, as
+   * skipping the evaluation would change the random number stream. Random expression leaves in
+   * target_if conditions are not detected; memoizing those changes results.
+   */
+  struct target_memo_t {
+    int iteration;
+    uint64_t epoch;
+    uint64_t variables;
+    uint64_t resources;
+    player_t* original_target;
+    player_t* result;
+    target_memo_t() : iteration( -1 ), epoch( 0 ), variables( 0 ), resources( 0 ), original_target(),
+      result() {}
+  } target_if_memo, cycle_targets_memo;
+
+  /// Scratch target lists for target_if and cycle_targets, reused to avoid allocation
+  std::vector< player_t* > target_if_list, cycle_targets_list;
+
 private:
   std::vector<std::unique_ptr<option_t>> options;
   action_state_t* state_cache;
@@ -5817,6 +6345,9 @@ public:
   { return sim -> rng(); }
 
   player_t* select_target_if_target();
+  player_t* find_target_if_target();
+  bool target_memo_valid( const target_memo_t& ) const;
+  void update_target_memo( target_memo_t&, player_t* original_target, player_t* result );
 
   // =======================
   // Const virtual functions
@@ -5926,6 +6457,8 @@ public:
   virtual std::vector<player_t*> targets_in_range_list( std::vector< player_t* >& tl ) const;
 
   virtual std::vector<player_t*> check_distance_targeting( std::vector< player_t* >& tl ) const;
+  // Spatial index query covering the targets the action can reach, nullptr if there is none
+  const spatial_index_t::query_t* distance_targeting_candidates() const;
 
   virtual double ppm_proc_chance( double PPM ) const;
 
@@ -6115,16 +6648,34 @@ public:
 
   virtual void reschedule_execute(timespan_t time);
 
+  /// Move the pending execute event to occur time from now in place, optionally releasing the
+  /// state it carries
+  void adjust_execute_event( timespan_t time, bool keep_state = true );
+
   virtual void update_ready(timespan_t cd_duration = timespan_t::min());
 
   virtual bool ready();
 
+  timespan_t earliest_ready_time() const;
+
+  bool profiled_ready();
+
   virtual void init();
 
   virtual bool init_finished();
 
+  void init_proc_callbacks();
+
+  // Trigger the proc callbacks of the actor for the proc type pair, through the pre-filtered
+  // per-action lists
+  void trigger_proc_callbacks( proc_types pt, proc_types2 pt2, action_state_t* state );
+
   virtual void reset();
 
+  // Action list expressions of the action, shared, cached, and compiled by the actor at the start
+  // of the first iteration, once all of its expressions have been optimized
+  virtual void collect_expressions( std::vector<expr_t**>& exprs );
+
   virtual void cancel();
 
   virtual void interrupt_action();
@@ -6640,10 +7191,15 @@ private:
   timespan_t extended_time; // Added time per extend_duration for the current dot application
   timespan_t reduced_time; // Removed time per reduce_duration for the current dot application
   int stack;
+  // Pending tick in the tick scheduler of the source, timespan_t::min() if none
+  timespan_t scheduled_tick;
+  uint64_t scheduled_tick_id;
 public:
   event_t* tick_event;
   event_t* end_event;
   double last_tick_factor;
+  // Registered on the touched dot list of the target for the next iteration reset
+  bool touched;
 
   player_t* const target;
   player_t* const source;
@@ -6663,6 +7219,9 @@ public:
   void   reduce_duration( timespan_t remove_seconds, uint32_t state_flags = -1 );
   void   refresh_duration( uint32_t state_flags = -1 );
   void   reset();
+  // Register the dot for the next iteration reset on its first state change in an iteration
+  void   touch();
+  bool   is_reset() const;
   void   cancel();
   void   trigger( timespan_t duration );
   void   decrement( int stacks );
@@ -6677,6 +7236,10 @@ public:
 
   timespan_t remains() const;
   timespan_t time_to_next_tick() const;
+  bool tick_scheduled() const
+  { return tick_event || scheduled_tick != timespan_t::min(); }
+  // Move the pending tick of the dot, or schedule one if there is none
+  void   reschedule_tick( timespan_t time_to_tick );
   timespan_t duration() const
   { return ! is_ticking() ? timespan_t::zero() : current_duration; }
   int    ticks_left() const;
@@ -6698,6 +7261,10 @@ public:
 private:
   void tick_zero();
   void schedule_tick();
+  void schedule_tick_event( timespan_t time_to_tick );
+  void cancel_tick();
+  timespan_t tick_remains() const;
+  void execute_tick();
   void start( timespan_t duration );
   void refresh( timespan_t duration );
   void check_tick_zero();
@@ -6705,6 +7272,7 @@ private:
 
   friend struct dot_tick_event_t;
   friend struct dot_end_event_t;
+  friend struct dot_tick_scheduler_t;
 };
 
 inline double action_t::last_tick_factor( const dot_t* /* d */, const timespan_t& time_to_tick, const timespan_t& duration ) const
@@ -6723,40 +7291,7 @@ inline dot_tick_event_t::dot_tick_event_t( dot_t* d, timespan_t time_to_tick ) :
 inline void dot_tick_event_t::execute()
 {
   dot -> tick_event = nullptr;
-  dot -> current_tick++;
-
-  if ( dot -> current_action -> channeled &&
-       dot -> current_action -> action_skill < 1.0 &&
-       dot -> remains() >= dot -> current_action -> tick_time( dot -> state ) )
-  {
-    if ( rng().roll( std::max( 0.0, dot -> current_action -> action_skill - dot -> current_action -> player -> current.skill_debuff ) ) )
-    {
-      dot -> tick();
-    }
-  }
-  else // No skill-check required
-  {
-    dot -> tick();
-  }
-
-  // Some dots actually cancel themselves mid-tick. If this happens, we presume
-  // that the cancel has been "proper", and just stop event execution here, as
-  // the dot no longer exists.
-  if ( ! dot -> is_ticking() )
-    return;
-
-  if ( ! dot -> current_action -> consume_cost_per_tick( *dot ) )
-  {
-    return;
-  }
-
-  if ( dot -> channel_interrupt() )
-  {
-    return;
-  }
-
-  // continue ticking
-  dot->schedule_tick();
+  dot -> execute_tick();
 }
 
 inline dot_end_event_t::dot_end_event_t( dot_t* d, timespan_t time_to_end ) :
@@ -6783,7 +7318,7 @@ inline void dot_end_event_t::execute()
   // in turn flip the order of the dot-tick-event and dot-end-event.
   else
   {
-    assert( ! dot -> tick_event || ( dot -> tick_event && dot -> time_to_tick == dot -> tick_event -> remains() ) );
+    assert( ! dot -> tick_scheduled() || dot -> time_to_tick == dot -> tick_remains() );
   }
 
   // Aand sanity check that the dot has consumed all ticks just in case./
@@ -6810,6 +7345,11 @@ struct action_callback_t : private noncopyable
   }
   virtual ~action_callback_t() {}
   virtual void trigger( action_t*, void* call_data ) = 0;
+  // Static filter, false if the callback can never trigger for the action. Used to build the
+  // pre-filtered per-action proc callback lists, so it may only depend on the weapon of the action
+  // and on state that does not change after initialization (e.g., the action id). Callbacks that
+  // reject actions on such state should do it here, instead of in trigger().
+  virtual bool can_trigger( const action_t* ) const { return true; }
   virtual void reset() {}
   virtual void initialize() { }
   virtual void activate() { active = true; }
@@ -6895,15 +7435,18 @@ struct dbc_proc_callback_t : public action_callback_t
 
   virtual void initialize() override;
 
+  // Weapon-based proc triggering differs from "old" callbacks. When used
+  // (weapon_proc == true), dbc_proc_callback_t _REQUIRES_ that the action
+  // has the correct weapon specified. Old style procs allowed actions
+  // without any weapon to pass through.
+  bool can_trigger( const action_t* a ) const override
+  { return ! weapon || a -> weapon == weapon; }
+
   void trigger( action_t* a, void* call_data ) override
   {
     if ( cooldown && cooldown -> down() ) return;
 
-    // Weapon-based proc triggering differs from "old" callbacks. When used
-    // (weapon_proc == true), dbc_proc_callback_t _REQUIRES_ that the action
-    // has the correct weapon specified. Old style procs allowed actions
-    // without any weapon to pass through.
-    if ( weapon && ( ! a -> weapon || ( a -> weapon && a -> weapon != weapon ) ) )
+    if ( ! can_trigger( a ) )
       return;
 
     bool triggered = roll( a );
@@ -7091,6 +7634,9 @@ std::string stat_to_str( int stat, int stat_amount );
 // Stat scaling methods for items, or item stats
 double approx_scale_coefficient( unsigned current_ilevel, unsigned new_ilevel );
 int scaled_stat( const item_t& item, const dbc_t& dbc, size_t idx, unsigned new_ilevel );
+// Memoized scaled values of all stats of an item
+typedef std::array<int, MAX_ITEM_STAT> stat_block_t;
+stat_block_t scaled_stats( const item_t& item, const dbc_t& dbc, unsigned new_ilevel );
 
 unsigned upgrade_ilevel( const item_t& item, unsigned upgrade_level );
 stat_pair_t item_enchantment_effect_stats( const item_enchantment_data_t& enchantment, int index );
@@ -7959,12 +8505,24 @@ void initialize_concordance( player_t& );
 
 inline buff_t* buff_t::find( sim_t* s, const std::string& name )
 {
-  return find( s -> buff_list, name );
+  return s -> buff_index.find( s -> buff_list, name );
 }
 inline buff_t* buff_t::find( player_t* p, const std::string& name, player_t* source )
 {
-  return find( p -> buff_list, name, source );
+  return p -> name_index.buff.find( p -> buff_list, name, [ source ]( const buff_t* b ) {
+    return ! source || source == b -> source;
+  } );
 }
+inline void buff_t::touch()
+{
+  if ( touched ) return;
+  touched = true;
+  if ( player )
+    player -> touched_buffs.push_back( this );
+  else
+    sim -> touched_buffs.push_back( this );
+}
+
 inline std::string buff_t::source_name() const
 {
   if ( player ) return player -> name_str;
@@ -7972,6 +8530,62 @@ inline std::string buff_t::source_name() const
 }
 inline rng::rng_t& buff_t::rng()
 { return sim -> rng(); }
+// dot_t inlines
+
+inline void dot_t::touch()
+{
+  if ( touched ) return;
+  touched = true;
+  target -> touched_dots.push_back( this );
+}
+
+// Reset objects (buffs or dots) at the start of an iteration. Objects register themselves on the
+// touched list on their first state change in an iteration, and with reset_touched_only, only
+// those are reset. The first iteration resets everything. With verify_reset, all objects are
+// checked against their reset state afterwards.
+//
+// reset_touched_only is opt-in: class module subclasses may keep state of their own that changes
+// without touching the object, and is_reset() only verifies the base class state.
+template <typename T>
+void reset_touched( sim_t& sim, const std::vector<T*>& objects, std::vector<T*>& touched )
+{
+  if ( ! sim.reset_touched_only || sim.current_iteration <= 0 )
+  {
+    touched.clear();
+    for ( T* obj : objects )
+    {
+      obj -> touched = false;
+      obj -> reset();
+    }
+    return;
+  }
+
+  // Objects may be touched again during the reset, so reset a detached list
+  std::vector<T*> list;
+  list.swap( touched );
+  for ( T* obj : list )
+  {
+    obj -> touched = false;
+    obj -> reset();
+  }
+  list.clear();
+  if ( touched.empty() )
+    touched.swap( list );
+
+  if ( sim.verify_reset )
+  {
+    for ( T* obj : objects )
+    {
+      if ( obj -> is_reset() )
+        continue;
+
+      sim.errorf( "%s changed state without registering for the iteration reset, iteration=%d",
+                  obj -> name(), sim.current_iteration );
+      obj -> reset();
+    }
+  }
+}
+
 // sim_t inlines
 
 inline buff_creator_t::operator buff_t* () const
@@ -7997,8 +8611,10 @@ inline void player_t::do_dynamic_regen()
   if ( sim -> current_time() == last_regen )
     return;
 
-  regen( sim -> current_time() - last_regen );
+  // Updated first, analytic regeneration brings resources up to date before each resource gain
+  timespan_t periodicity = sim -> current_time() - last_regen;
   last_regen = sim -> current_time();
+  regen( periodicity );
 
   if ( dynamic_regen_pets )
   {
@@ -8010,6 +8626,19 @@ inline void player_t::do_dynamic_regen()
   }
 }
 
+inline double player_t::resource_current( resource_e r ) const
+{
+  double value = resources.current[ r ];
+  if ( ! analytic_regen || sim -> current_time() == last_regen || value >= resources.max[ r ] )
+    return value;
+
+  double rate = resource_regen_per_second( r );
+  if ( rate <= 0 || current.sleeping )
+    return value;
+
+  return std::min( resources.max[ r ], value + rate * ( sim -> current_time() - last_regen ).total_seconds() );
+}
+
 inline target_wrapper_expr_t::target_wrapper_expr_t( action_t& a, const std::string& name_str, const std::string& expr_str ) :
   expr_t( name_str ), action( a ), suffix_expr_str( expr_str )
 {
@@ -8576,6 +9205,8 @@ void effect_callbacks_t<T_CB>::add_proc_callback( proc_types type,
   if ( sim -> debug )
     s << "Registering procs: ";
 
+  version++;
+
   // Setup the proc-on-X types for the proc
   for ( proc_types2 pt = PROC2_TYPE_MIN; pt < PROC2_TYPE_MAX; pt++ )
   {
@@ -5,6 +5,10 @@
 
 #pragma once
 
+#include <unordered_map>
+
+#include "concurrency.hpp"
+
 // Cache Control ============================================================
 
 namespace cache {
@@ -66,4 +70,42 @@ inline behavior_e items()
 inline void items( behavior_e b )
 { cache_control_t::singleton.cache_items( b ); }
 
+// Thread-safe memoization table for immutable data derived purely from its key. Tables are meant
+// to be process-wide, so that all simulations of the process (threads, profilesets) share them.
+template <typename Key, typename Value, typename Hash = std::hash<Key>>
+class memo_t
+{
+private:
+  mutex_t mutex;
+  std::unordered_map<Key, Value, Hash> data;
+
+public:
+  bool get( const Key& key, Value& value )
+  {
+    AUTO_LOCK( mutex );
+
+    auto it = data.find( key );
+    if ( it == data.end() )
+      return false;
+
+    value = it -> second;
+    return true;
+  }
+
+  void set( const Key& key, const Value& value )
+  {
+    AUTO_LOCK( mutex );
+    data[ key ] = value;
+  }
+
+  size_t size()
+  {
+    AUTO_LOCK( mutex );
+    return data.size();
+  }
+};
+
+inline void hash_combine( size_t& seed, size_t v )
+{ seed ^= v + 0x9e3779b9 + ( seed << 6 ) + ( seed >> 2 ); }
+
 } // cache